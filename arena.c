@@ -0,0 +1,57 @@
+/*
+ * arena.c
+ *
+ * Contiguous regions of tree nodes.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "arena.h"
+
+
+bst_arena* bst_arena_create(size_t node_size, size_t capacity, bst_arena* next)
+{
+    bst_arena* arena = malloc(sizeof(bst_arena));
+    char* base = malloc(node_size * (capacity ? capacity : 1));
+    if (!arena || !base) {
+        fprintf(stderr, "MEMORY ERROR in bst_arena_create. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    arena->base = base;
+    arena->node_size = node_size;
+    arena->capacity = capacity;
+    arena->used = 0;
+    arena->live = 0;
+    arena->next = next;
+
+    return arena;
+}
+
+
+void bst_arena_destroy(bst_arena* arena)
+{
+    free(arena->base);
+    free(arena);
+}
+
+
+bstnode* bst_arena_alloc(bst_arena* arena)
+{
+    // the next slot, in address order, or NULL if the arena is full
+    if (arena->used == arena->capacity) return NULL;
+
+    arena->live++;
+    return (bstnode*) (arena->base + arena->node_size * arena->used++);
+}
+
+
+int bst_arena_contains(bst_arena* arena, const bstnode* node)
+{
+    const char* address = (const char*) node;
+    return address >= arena->base && address < arena->base + arena->node_size * arena->capacity;
+}
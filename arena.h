@@ -0,0 +1,38 @@
+/*
+ * arena.h
+ *
+ * Contiguous regions of nodes, filled by avl_compact as it relocates a tree's
+ * nodes into key order, so that neighbouring keys share cache lines and
+ * pages. A tree keeps a list of its arenas, and nodes are freed through
+ * bst_free_node, which tells arena nodes apart from malloc'd ones. A slot
+ * isn't reused once its node is freed, but an arena is released as a whole
+ * once every node it was given has been freed (as happens to the old arena
+ * on the next compaction).
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include <stddef.h>
+#include "nodes.h"
+
+typedef struct BSTArena {
+    char* base;
+    size_t node_size;
+
+    // slots in the region, slots handed out so far, and handed out slots
+    // whose nodes haven't been freed
+    size_t capacity;
+    size_t used;
+    size_t live;
+
+    struct BSTArena* next;
+} bst_arena;
+
+bst_arena* bst_arena_create(size_t node_size, size_t capacity, bst_arena* next);
+void bst_arena_destroy(bst_arena* arena);
+
+bstnode* bst_arena_alloc(bst_arena* arena);
+int bst_arena_contains(bst_arena* arena, const bstnode* node);
@@ -0,0 +1,192 @@
+/*
+ * augment.c
+ *
+ * Generalized subtree augmentation.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "augment.h"
+
+
+bst_aggregate bst_lift_key(const bstnode* node)
+{
+    return node->value;
+}
+
+
+bst_aggregate bst_lift_key_squared(const bstnode* node)
+{
+    return (bst_aggregate) node->value * node->value;
+}
+
+
+bst_aggregate bst_lift_payload(const bstnode* node)
+{
+    return BST_PAYLOAD(node);
+}
+
+
+bst_aggregate bst_lift_payload_squared(const bstnode* node)
+{
+    return BST_PAYLOAD(node) * BST_PAYLOAD(node);
+}
+
+
+bst_aggregate bst_lift_one(const bstnode* node)
+{
+    (void) node;
+    return 1;
+}
+
+
+bst_aggregate bst_combine_sum(bst_aggregate left, bst_aggregate right)
+{
+    return left + right;
+}
+
+
+bst_aggregate bst_combine_min(bst_aggregate left, bst_aggregate right)
+{
+    return (left < right) ? left : right;
+}
+
+
+bst_aggregate bst_combine_max(bst_aggregate left, bst_aggregate right)
+{
+    return (left > right) ? left : right;
+}
+
+
+bst* bst_create_augmented(const bst_monoid* monoids, int count)
+{
+    assert(count > 0 && count <= BST_MAX_MONOIDS);
+
+    bst* tree = bst_create();
+    tree->augment = malloc(sizeof(bst_augment));
+    if (!tree->augment) {
+        fprintf(stderr, "MEMORY ERROR in bst_create_augmented. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    tree->augment->count = count;
+    memcpy(tree->augment->monoids, monoids, sizeof(bst_monoid) * count);
+
+    return tree;
+}
+
+
+size_t bst_node_size(bst* tree)
+{
+    if (!tree->augment) {
+        return sizeof(bstnode);
+    }
+
+    // one slot for the payload, and one per monoid
+    return sizeof(bstnode) + sizeof(bst_aggregate) * (tree->augment->count + 1);
+}
+
+
+static bst_aggregate _bst_lift(const bst_monoid* m, const bstnode* node)
+{
+    // dead nodes (see avl_set_lazy_delete) contribute nothing
+    return (node->dead) ? m->identity : m->lift(node);
+}
+
+
+bst_aggregate bst_subtree_aggregate(bst* tree, bstnode* head, int monoid)
+{
+    return (head) ? BST_AGGREGATE(head, monoid) : tree->augment->monoids[monoid].identity;
+}
+
+
+void bst_update_aggregates(bst* tree, bstnode* target)
+{
+    // recompute the aggregates of target from those of its children,
+    // which are assumed to be up to date.
+    for (int i=0; i<tree->augment->count; i++) {
+        bst_monoid* m = &tree->augment->monoids[i];
+        bst_aggregate agg = _bst_lift(m, target);
+
+        if (target->left)
+            agg = m->combine(BST_AGGREGATE(target->left, i), agg);
+        if (target->right)
+            agg = m->combine(agg, BST_AGGREGATE(target->right, i));
+
+        BST_AGGREGATE(target, i) = agg;
+    }
+}
+
+
+void bst_update_path_aggregates(bst* tree, bstnode* target)
+{
+    if (!tree->augment) return;
+
+    while (target) {
+        bst_update_aggregates(tree, target);
+        target = target->parent;
+    }
+}
+
+
+void bst_set_payload(bst* tree, bstnode* target, bst_aggregate payload)
+{
+    assert(tree->augment);
+
+    BST_PAYLOAD(target) = payload;
+    bst_update_path_aggregates(tree, target);
+}
+
+
+bst_aggregate bst_range_aggregate(bst* tree, bst_key lo, bst_key hi, int monoid)
+{
+    bst_monoid* m = &tree->augment->monoids[monoid];
+
+    // find the highest node within the range. Everything else in the range
+    // lies in its subtree.
+    bstnode* split = tree->head;
+    while (split && (split->value < lo || split->value > hi)) {
+        split = (split->value < lo) ? split->right : split->left;
+    }
+
+    if (!split) {
+        return m->identity;
+    }
+
+    // walk down the left boundary of the range. Each node at or above lo
+    // contributes itself and its right subtree, which lie to the right of
+    // anything found further down.
+    bst_aggregate left = m->identity;
+    bstnode* current = split->left;
+    while (current) {
+        if (current->value >= lo) {
+            bst_aggregate part = m->combine(_bst_lift(m, current),
+                    bst_subtree_aggregate(tree, current->right, monoid));
+            left = m->combine(part, left);
+            current = current->left;
+        } else {
+            current = current->right;
+        }
+    }
+
+    // and likewise down the right boundary
+    bst_aggregate right = m->identity;
+    current = split->right;
+    while (current) {
+        if (current->value <= hi) {
+            bst_aggregate part = m->combine(bst_subtree_aggregate(tree,
+                        current->left, monoid), _bst_lift(m, current));
+            right = m->combine(right, part);
+            current = current->right;
+        } else {
+            current = current->left;
+        }
+    }
+
+    return m->combine(m->combine(left, _bst_lift(m, split)), right);
+}
@@ -0,0 +1,64 @@
+/*
+ * augment.h
+ *
+ * Generalized subtree augmentation. Rank is the one augmentation that every
+ * tree carries, but a tree can also be created with up to BST_MAX_MONOIDS
+ * user-declared monoids. Each node then stores a payload along with, for
+ * each monoid, the combination of the lifted values of every node in its
+ * subtree (in key order). These are kept up to date by the shared rotation,
+ * insert and unlink code, so any range of keys can be aggregated in
+ * O(lg n) time.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include <limits.h>
+#include "bst.h"
+
+#define BST_MAX_MONOIDS 4
+
+typedef struct BSTMonoid {
+    bst_aggregate identity;
+
+    // the value that a single node contributes to the aggregate
+    bst_aggregate (*lift)(const bstnode* node);
+
+    // an associative operation combining the aggregates of two adjacent
+    // ranges of keys, with left preceding right.
+    bst_aggregate (*combine)(bst_aggregate left, bst_aggregate right);
+} bst_monoid;
+
+typedef struct BSTAugment {
+    int count;
+    bst_monoid monoids[BST_MAX_MONOIDS];
+} bst_augment;
+
+#define BST_PAYLOAD(node) ((node)->aug[0])
+#define BST_AGGREGATE(node, monoid) ((node)->aug[(monoid) + 1])
+
+// Some common monoids, to be used with one of the lift functions below
+#define BST_MONOID_SUM(lift) { 0, lift, bst_combine_sum }
+#define BST_MONOID_MIN(lift) { LLONG_MAX, lift, bst_combine_min }
+#define BST_MONOID_MAX(lift) { LLONG_MIN, lift, bst_combine_max }
+
+bst_aggregate bst_lift_key(const bstnode* node);
+bst_aggregate bst_lift_key_squared(const bstnode* node);
+bst_aggregate bst_lift_payload(const bstnode* node);
+bst_aggregate bst_lift_payload_squared(const bstnode* node);
+bst_aggregate bst_lift_one(const bstnode* node);
+
+bst_aggregate bst_combine_sum(bst_aggregate left, bst_aggregate right);
+bst_aggregate bst_combine_min(bst_aggregate left, bst_aggregate right);
+bst_aggregate bst_combine_max(bst_aggregate left, bst_aggregate right);
+
+bst* bst_create_augmented(const bst_monoid* monoids, int count);
+size_t bst_node_size(bst* tree);
+
+bst_aggregate bst_subtree_aggregate(bst* tree, bstnode* head, int monoid);
+void bst_update_aggregates(bst* tree, bstnode* target);
+void bst_update_path_aggregates(bst* tree, bstnode* target);
+void bst_set_payload(bst* tree, bstnode* target, bst_aggregate payload);
+bst_aggregate bst_range_aggregate(bst* tree, bst_key lo, bst_key hi, int monoid);
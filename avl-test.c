@@ -12,6 +12,7 @@
 #include <stdio.h>
 #include <time.h>
 #include <string.h>
+#include <math.h>
 
 #include "avl.h"
 #include "bst-util.h"
@@ -40,7 +41,7 @@ int standard_tests()
     avl_insert(tree, 0);
     avl_insert(tree, 15);
 
-    printf("%d\n", tree->length);
+    printf(BST_SIZE_FMT "\n", tree->length);
     assert(tree->length == 5);
     printf("avl_insert of numbers passed.\n");
 
@@ -177,10 +178,6 @@ int example_tree()
     // insert 48, and then do a left-rotation about 15
     printf("should rotate left\n");
     avl_insert(test, 48);
-    bstnode* b = avl_search(test, 15);
-    bstnode* a = b->parent;
-
-    //avl_rotate_left(test, a);    
     
 
     inorder_traverse(test->head);
@@ -193,10 +190,6 @@ int example_tree()
     // insert 25 and do a right-rotation about 31.
     printf("should rotate right\n");
     avl_insert(test, 25);
-    b = avl_search(test, 31);
-    a = b->parent;
-
-    //avl_rotate_right(test, a);
 
     inorder_traverse(test->head);
     printf("\n");
@@ -205,10 +198,6 @@ int example_tree()
     // insert 41 and do a left-rotation about 31
     printf("should rotate left\n");
     avl_insert(test, 41);
-    b = avl_search(test, 31);
-    a = b->parent;
-
-    //avl_rotate_left(test, a);
 
     inorder_traverse(test->head);
     printf("\n");
@@ -332,6 +321,1056 @@ int rotation_stress(int n)
 }
 
 
+int delete_stress(int n)
+{
+    // interleave random inserts and deletes, checking that the
+    // balance factors, ranks and parent pointers all stay consistent.
+    bst* test = avl_create();
+
+    srand(time(NULL));
+    printf("Inserting and deleting %d random numbers...\n", n);
+    for (int i = 0; i < n; i++) {
+        avl_insert(test, rand() % n);
+        int x = rand() % n;
+        int present = (avl_search(test, x) != NULL);
+        assert(avl_delete(test, x) == present);
+        assert(avl_search(test, x) == NULL);
+    }
+
+    check_balance_factors(test->head);
+    check_strict_balance(test->head, 0);
+    check_parent_links(test->head);
+    assert(check_subtree_ranks(test->head) == test->length);
+    check_bst_indexing(test);
+
+    printf("Deleting everything...\n");
+    while (test->length) {
+        assert(avl_delete(test, avl_index(test, 1 + rand() % test->length)->value));
+    }
+    assert(!test->head);
+
+    printf("Passed\n");
+
+    avl_clear_destroy(test);
+    return 0;
+}
+
+
+void check_aggregates(bst* tree, bstnode* head)
+{
+    if (head == NULL) return;
+
+    check_aggregates(tree, head->left);
+    check_aggregates(tree, head->right);
+
+    bst_aggregate old[BST_MAX_MONOIDS];
+    for (int i=0; i<tree->augment->count; i++)
+        old[i] = BST_AGGREGATE(head, i);
+
+    bst_update_aggregates(tree, head);
+
+    for (int i=0; i<tree->augment->count; i++)
+        assert(old[i] == BST_AGGREGATE(head, i));
+}
+
+
+int aggregate_tests(int n)
+{
+    bst_monoid monoids[] = {
+        BST_MONOID_SUM(bst_lift_payload),
+        BST_MONOID_MIN(bst_lift_key),
+        BST_MONOID_MAX(bst_lift_key),
+        BST_MONOID_SUM(bst_lift_payload_squared)
+    };
+
+    bst* test = avl_create_augmented(monoids, 4);
+
+    // the payload of each key is tracked on the side, to check the range
+    // aggregates against a straightforward scan.
+    bst_aggregate* payloads = calloc(n, sizeof(bst_aggregate));
+
+    srand(time(NULL));
+    printf("Inserting and deleting %d random numbers with payloads...\n", n);
+    for (int i = 0; i < n; i++) {
+        int x = rand() % n;
+        payloads[x] = rand() % 1000 - 500;
+        avl_insert_payload(test, x, payloads[x]);
+
+        int y = rand() % n;
+        avl_delete(test, y);
+        payloads[y] = 0;
+    }
+
+    check_aggregates(test, test->head);
+    check_balance_factors(test->head);
+    assert(check_subtree_ranks(test->head) == test->length);
+
+    printf("Checking random range aggregates...\n");
+    for (int i = 0; i < 1000; i++) {
+        int lo = rand() % n;
+        int hi = lo + rand() % (n - lo);
+
+        bst_aggregate sum = 0, sumsq = 0, min = LLONG_MAX, max = LLONG_MIN;
+        for (int x = lo; x <= hi; x++) {
+            if (!avl_search(test, x)) continue;
+            sum += payloads[x];
+            sumsq += payloads[x] * payloads[x];
+            min = MIN(min, x);
+            max = MAX(max, x);
+        }
+
+        assert(avl_range_aggregate(test, lo, hi, 0) == sum);
+        assert(avl_range_aggregate(test, lo, hi, 1) == min);
+        assert(avl_range_aggregate(test, lo, hi, 2) == max);
+        assert(avl_range_aggregate(test, lo, hi, 3) == sumsq);
+    }
+
+    assert(avl_range_aggregate(test, 10, 5, 0) == 0);
+    assert(avl_range_aggregate(test, n, 2 * n, 1) == LLONG_MAX);
+
+    printf("Passed\n");
+
+    free(payloads);
+    avl_clear_destroy(test);
+    return 0;
+}
+
+
+int batch_tests(int n)
+{
+    bst* test = avl_create();
+
+    srand(time(NULL));
+    for (int i = 0; i < n; i++) {
+        avl_insert(test, rand() % (2 * n));
+    }
+
+    // try both a small batch (shared descent) and a large one (in-order
+    // merge), including ranks and keys that aren't in the tree.
+    size_t sizes[] = {1, 37, n / 2, 3 * n};
+    for (int s = 0; s < 4; s++) {
+        size_t k = sizes[s];
+        printf("Checking batches of %zu queries...\n", k);
+
+        bst_key* queries = malloc(sizeof(bst_key) * k);
+        bstnode** nodes = malloc(sizeof(bstnode*) * k);
+        bst_size* indexes = malloc(sizeof(bst_size) * k);
+
+        for (size_t i = 0; i < k; i++)
+            queries[i] = rand() % (test->length + 10) - 5;
+
+        avl_index_batch(test, queries, k, nodes);
+        for (size_t i = 0; i < k; i++)
+            assert(nodes[i] == avl_index(test, queries[i]));
+
+        for (size_t i = 0; i < k; i++)
+            queries[i] = rand() % (2 * n + 10) - 5;
+
+        avl_get_index_batch(test, queries, k, indexes);
+        for (size_t i = 0; i < k; i++)
+            assert(indexes[i] == avl_get_index(test, queries[i]));
+
+        free(queries);
+        free(nodes);
+        free(indexes);
+    }
+
+    printf("Checking batches with the smallest and largest keys...\n");
+    avl_insert(test, BST_KEY_MIN);
+    avl_insert(test, BST_KEY_MAX);
+    for (int s = 0; s < 2; s++) {
+        // a shared descent, then an in-order merge
+        size_t k = (s) ? 3 * n : 4;
+        bst_key* queries = malloc(sizeof(bst_key) * k);
+        bst_size* indexes = malloc(sizeof(bst_size) * k);
+
+        queries[0] = BST_KEY_MAX;
+        queries[1] = BST_KEY_MIN;
+        queries[2] = BST_KEY_MAX - 1;
+        queries[3] = BST_KEY_MIN + 1;
+        for (size_t i = 4; i < k; i++)
+            queries[i] = (i % 2) ? BST_KEY_MAX : rand() % (2 * n);
+
+        avl_get_index_batch(test, queries, k, indexes);
+        assert(indexes[0] == test->length && indexes[1] == 1);
+        assert(indexes[2] == -1 && indexes[3] == -1);
+        for (size_t i = 0; i < k; i++)
+            assert(indexes[i] == avl_get_index(test, queries[i]));
+
+        free(queries);
+        free(indexes);
+    }
+
+    printf("Passed\n");
+
+    avl_clear_destroy(test);
+    return 0;
+}
+
+
+int search_many_tests(int n)
+{
+    bst* test = avl_create();
+
+    srand(time(NULL));
+    for (int i = 0; i < n; i++) {
+        avl_insert(test, rand() % (2 * n));
+    }
+
+    bst_key* queries = malloc(sizeof(bst_key) * n);
+    bstnode** found = malloc(sizeof(bstnode*) * n);
+    for (int i = 0; i < n; i++)
+        queries[i] = rand() % (2 * n);
+
+    int groups[] = {1, 3, 16, 64, 1000};
+    for (int g = 0; g < 5; g++) {
+        printf("Checking interleaved searches with group size %d...\n", groups[g]);
+        memset(found, 0, sizeof(bstnode*) * n);
+        bst_search_many(test, queries, n, found, groups[g]);
+
+        for (int i = 0; i < n; i++)
+            assert(found[i] == avl_search(test, queries[i]));
+    }
+
+    avl_search_many(test, queries, 0, found);
+    avl_search_many(test, queries, n, found);
+    for (int i = 0; i < n; i++)
+        assert(found[i] == avl_search(test, queries[i]));
+
+    printf("Passed\n");
+
+    free(queries);
+    free(found);
+    avl_clear_destroy(test);
+    return 0;
+}
+
+
+int neighbor_tests(int n)
+{
+    bst* test = avl_create();
+    char* present = calloc(2 * n, 1);
+
+    srand(time(NULL));
+    for (int i = 0; i < n; i++) {
+        int x = rand() % (2 * n);
+        avl_insert(test, x);
+        present[x] = 1;
+    }
+
+    printf("Checking ordered-neighbor queries...\n");
+    for (int i = 0; i < 5000; i++) {
+        int x = rand() % (2 * n + 20) - 10;
+
+        // find the expected neighbors, and their ranks, with a scan
+        int below = -1, below_rank = 0, above = -1, above_rank = 0, count = 0;
+        for (int y = 0; y < 2 * n; y++) {
+            if (!present[y]) continue;
+            count++;
+            if (y < x) {
+                below = y;
+                below_rank = count;
+            } else if (y > x && above == -1) {
+                above = y;
+                above_rank = count;
+            }
+        }
+
+        int exact = (x >= 0 && x < 2 * n && present[x]);
+        bst_size rank;
+
+        bstnode* node = avl_lower_bound(test, x, &rank);
+        if (exact) {
+            assert(node->value == x && rank == avl_get_index(test, x));
+        } else if (above == -1) {
+            assert(!node && rank == test->length + 1);
+        } else {
+            assert(node->value == above && rank == above_rank);
+        }
+
+        node = avl_upper_bound(test, x, &rank);
+        assert(node == avl_successor(test, x, NULL));
+        if (above == -1) {
+            assert(!node && rank == test->length + 1);
+        } else {
+            assert(node->value == above && rank == above_rank);
+            assert(avl_prev(node) == (below == -1 ? NULL : avl_search(test, below)) || exact);
+        }
+
+        node = avl_predecessor(test, x, &rank);
+        if (below == -1) {
+            assert(!node && rank == 0);
+        } else {
+            assert(node->value == below && rank == below_rank);
+            assert(avl_next(node) == (exact ? avl_search(test, x) : avl_upper_bound(test, x, NULL)));
+        }
+
+        node = avl_nearest(test, x, &rank);
+        if (exact) {
+            assert(node->value == x);
+        } else if (below != -1 && (above == -1 || x - below <= above - x)) {
+            assert(node->value == below && rank == below_rank);
+        } else if (above != -1) {
+            assert(node->value == above && rank == above_rank);
+        }
+    }
+
+    printf("Checking in-order stepping...\n");
+    int index = 0;
+    for (bstnode* node = avl_index(test, 1); node; node = avl_next(node))
+        assert(avl_index(test, ++index) == node);
+    assert(index == test->length);
+
+    for (bstnode* node = avl_index(test, test->length); node; node = avl_prev(node))
+        assert(avl_index(test, index--) == node);
+    assert(index == 0);
+
+    printf("Passed\n");
+
+    free(present);
+    avl_clear_destroy(test);
+    return 0;
+}
+
+
+int memory_tests(int n)
+{
+    bst* test = avl_create();
+    avl_stats stats, exact;
+
+    avl_memory_stats(test, &stats, 0);
+    assert(stats.nodes == 0 && stats.node_bytes == 0 && stats.height == 0);
+
+    // a perfect tree of seven nodes, whose depths sum to 1 + 2 * 2 + 4 * 3
+    printf("Checking the depth estimate on a perfect tree...\n");
+    int perfect[] = {4, 2, 6, 1, 3, 5, 7};
+    for (int i = 0; i < 7; i++)
+        avl_insert(test, perfect[i]);
+    avl_memory_stats(test, &stats, 0);
+    avl_memory_stats(test, &exact, 1);
+    assert(exact.height == 3 && fabs(exact.average_depth - 17.0 / 7) < 1e-9);
+    assert(fabs(stats.average_depth - 17.0 / 7) < 1e-9);
+    for (int i = 0; i < 7; i++)
+        avl_delete(test, perfect[i]);
+
+    srand(time(NULL));
+    printf("Checking memory stats through random inserts and deletes...\n");
+    for (int i = 0; i < n; i++) {
+        avl_insert(test, rand() % n);
+        if (rand() % 3 == 0)
+            avl_delete(test, rand() % n);
+
+        if (i % 100 == 0) {
+            avl_memory_stats(test, &stats, 0);
+            avl_memory_stats(test, &exact, 1);
+
+            assert(stats.nodes == test->length);
+            assert(stats.node_bytes == test->length * sizeof(bstnode));
+            assert(stats.height == calculate_tree_height(test->head));
+            assert(stats.height == exact.height);
+            assert(stats.height <= stats.height_bound);
+            assert(exact.average_depth >= 1 && exact.average_depth <= exact.height);
+            assert(fabs(stats.average_depth - exact.average_depth) < 1);
+            assert(stats.overhead_bytes >= 8 * (size_t) test->length);
+        }
+    }
+
+    while (test->length) {
+        avl_delete(test, avl_index(test, 1)->value);
+    }
+    avl_memory_stats(test, &stats, 1);
+    assert(stats.height == 0 && stats.nodes == 0);
+    assert(stats.tracker_peak_bytes > 0);
+
+    printf("Passed\n");
+
+    avl_clear_destroy(test);
+    return 0;
+}
+
+
+int priority_queue_tests(int n)
+{
+    bst* test = avl_create();
+    char* present = calloc(n, 1);
+    bst_key value;
+
+    assert(!avl_peek_min(test) && !avl_peek_max(test));
+    assert(avl_pop_min(test, &value) == 0);
+    assert(avl_pop_max(test, &value) == 0);
+    assert(avl_delete_at(test, 1, &value) == 0);
+
+    srand(time(NULL));
+    for (int i = 0; i < n; i++) {
+        int x = rand() % n;
+        avl_insert(test, x);
+        present[x] = 1;
+    }
+    check_extremes(test);
+
+    printf("Checking delete by rank...\n");
+    for (int i = 0; i < n / 4; i++) {
+        int rank = rand() % (test->length + 2);
+        int expected = (rank >= 1 && rank <= test->length) ? avl_index(test, rank)->value : -1;
+
+        assert(avl_delete_at(test, rank, &value) == (expected != -1));
+        if (expected != -1) {
+            assert(value == expected);
+            present[value] = 0;
+        }
+    }
+    check_balance_factors(test->head);
+    check_strict_balance(test->head, 0);
+    assert(check_subtree_ranks(test->head) == test->length);
+    check_extremes(test);
+
+    printf("Checking pop min and max...\n");
+    int lo = 0, hi = n - 1;
+    while (test->length) {
+        int from_min = rand() % 2;
+        int peeked = from_min ? avl_peek_min(test)->value : avl_peek_max(test)->value;
+
+        if (from_min) {
+            while (!present[lo]) lo++;
+            assert(avl_pop_min(test, &value) == 1);
+            assert(value == lo++);
+        } else {
+            while (!present[hi]) hi--;
+            assert(avl_pop_max(test, &value) == 1);
+            assert(value == hi--);
+        }
+
+        assert(value == peeked);
+        check_extremes(test);
+        if (test->length % 256 == 0) {
+            check_balance_factors(test->head);
+            assert(check_subtree_ranks(test->head) == test->length);
+        }
+    }
+    assert(!test->head && test->height == 0);
+
+    printf("Passed\n");
+
+    free(present);
+    avl_clear_destroy(test);
+    return 0;
+}
+
+
+int lazy_delete_tests(int n)
+{
+    bst* test = avl_create_augmented((bst_monoid[]) {BST_MONOID_SUM(bst_lift_key)}, 1);
+    char* present = calloc(n, 1);
+    avl_stats stats;
+
+    avl_set_lazy_delete(test, 0.25, 4);
+
+    srand(time(NULL));
+    printf("Checking lazy deletes against a scan...\n");
+    for (int i = 0; i < 20 * n; i++) {
+        int x = rand() % n;
+        if (rand() % 2) {
+            assert(avl_insert(test, x) == !present[x]);
+            present[x] = 1;
+        } else {
+            assert(avl_delete(test, x) == present[x]);
+            present[x] = 0;
+        }
+
+        // a sweep over the tree at 4 nodes per operation can at most see
+        // the dead fraction double before it finishes.
+        assert(test->dead <= 0.5 * (test->length + test->dead) + 4);
+
+        if (i % 1000 == 0) {
+            check_bst_ordering(test);
+            check_parent_links(test->head);
+            check_extremes(test);
+            check_balance_factors(test->head);
+            assert(check_subtree_ranks(test->head) == test->length);
+            check_bst_indexing(test);
+            check_aggregates(test, test->head);
+
+            avl_memory_stats(test, &stats, 0);
+            assert(stats.nodes == test->length + test->dead);
+
+            int index = 0;
+            long long sum = 0;
+            for (int y = 0; y < n; y++) {
+                if (!present[y]) continue;
+                index++;
+                sum += y;
+                assert(avl_search(test, y)->value == y);
+                assert(avl_get_index(test, y) == index);
+            }
+            assert(index == test->length);
+            assert(avl_range_aggregate(test, 0, n, 0) == sum);
+
+            for (int y = 0; y < n; y++) {
+                bst_size rank;
+                bstnode* node = avl_lower_bound(test, y, &rank);
+                assert(rank == avl_get_index(test, node ? node->value : n) || (!node && rank == test->length + 1));
+                if (!present[y]) assert(!avl_search(test, y) && avl_get_index(test, y) == -1);
+            }
+        }
+    }
+
+    printf("Checking pops skip dead nodes...\n");
+    bst_key value, last = -1;
+    while (avl_pop_min(test, &value)) {
+        assert(present[value] && value > last);
+        assert(!avl_peek_min(test) || !avl_peek_min(test)->dead);
+        last = value;
+    }
+    assert(test->length == 0 && !avl_peek_min(test) && !avl_peek_max(test));
+
+    // whatever dead nodes are left are trimmed away by later operations
+    for (int i = 0; test->dead; i++) {
+        assert(i < n);
+        avl_insert(test, n);
+        avl_delete(test, n);
+    }
+    assert(!test->head);
+
+    printf("Checking a pop next to a run of dead nodes is bounded...\n");
+    for (int x = 0; x < n; x++)
+        avl_insert(test, x);
+    for (int x = 1; x < n / 2; x++)
+        avl_delete(test, x);
+
+    // the trimming and the sweep each remove at most compact_step nodes
+    while (test->dead > 2 * test->compact_step) {
+        bst_size dead = test->dead;
+        bst_key expected = avl_peek_min(test)->value;
+        assert(avl_pop_min(test, &value) && value == expected);
+        assert(dead - test->dead <= 2 * test->compact_step);
+        check_extremes(test);
+        assert(check_subtree_ranks(test->head) == test->length);
+    }
+    avl_clear_destroy(test);
+
+    printf("Checking an insert after the last live key goes keeps the dead ones...\n");
+    test = avl_create();
+    avl_set_lazy_delete(test, 0.99, 4);
+    for (int x = 1; x <= 100; x++)
+        avl_insert(test, x);
+    for (int x = 2; x < 100; x++)
+        avl_delete(test, x);
+    avl_delete(test, 1);
+    avl_delete(test, 100);
+    assert(test->length == 0 && test->dead > 0 && test->head);
+    assert(!avl_peek_min(test) && !avl_peek_max(test));
+
+    avl_insert(test, 50);
+    assert(test->length == 1 && avl_search(test, 50));
+    assert(avl_peek_min(test)->value == 50 && avl_peek_max(test)->value == 50);
+
+    bst_size linked = 0;
+    for (bstnode* node = bst_node_min(test->head); node; node = bst_node_next(node))
+        linked++;
+    avl_memory_stats(test, &stats, 0);
+    assert(linked == test->length + test->dead && stats.nodes == linked);
+    check_parent_links(test->head);
+    assert(check_subtree_ranks(test->head) == test->length);
+
+    printf("Passed\n");
+
+    free(present);
+    avl_clear_destroy(test);
+    return 0;
+}
+
+
+int hash_tests(int n)
+{
+    bst* test = avl_create();
+    char* present = calloc(n, 1);
+    avl_stats stats;
+
+    avl_enable_hash(test);
+    avl_memory_stats(test, &stats, 0);
+    assert(stats.index_bytes > 0);
+
+    srand(time(NULL));
+    printf("Checking hashed searches through inserts and deletes...\n");
+    for (int i = 0; i < 10 * n; i++) {
+        bst_key x = rand() % n;
+        int op = rand() % 4;
+
+        if (op < 2) {
+            avl_insert(test, x);
+            present[x] = 1;
+        } else if (op == 2) {
+            avl_delete(test, x);
+            present[x] = 0;
+        } else if (avl_pop_min(test, &x)) {
+            present[x] = 0;
+        }
+
+        // switch to lazy deletes halfway through, so dead nodes (and their
+        // compaction) are covered as well.
+        if (i == 5 * n)
+            avl_set_lazy_delete(test, 0.25, 4);
+
+        if (i % 1000 == 0) {
+            assert(test->hash->count == (size_t) (test->length + test->dead));
+            for (int y = 0; y < n; y++) {
+                bstnode* node = avl_search(test, y);
+                assert(present[y] ? node && node->value == y : !node);
+            }
+        }
+    }
+
+    printf("Checking the index can be rebuilt...\n");
+    avl_disable_hash(test);
+    assert(!test->hash);
+    avl_enable_hash(test);
+    for (int y = 0; y < n; y++)
+        assert(!avl_search(test, y) == !present[y]);
+
+    printf("Passed\n");
+
+    free(present);
+    avl_clear_destroy(test);
+    return 0;
+}
+
+
+int trace_tests(int n)
+{
+    const char* path = "avl-test.trace";
+    bst* test = avl_create();
+    trace_record* expected = malloc(sizeof(trace_record) * n);
+
+    assert(avl_start_trace(test, path));
+
+    srand(time(NULL));
+    printf("Recording a trace...\n");
+    for (int i = 0; i < n; i++) {
+        int op = rand() % TRACE_OPS;
+        int arg = rand() % 1000 - 500;
+        expected[i] = (trace_record) {op, arg};
+
+        switch (op) {
+            case TRACE_INSERT: avl_insert(test, arg); break;
+            case TRACE_DELETE: avl_delete(test, arg); break;
+            case TRACE_SEARCH: avl_search(test, arg); break;
+            case TRACE_INDEX: avl_index(test, arg); break;
+            case TRACE_GET_INDEX: avl_get_index(test, arg); break;
+        }
+    }
+
+    assert(test->trace->records == n);
+    avl_stop_trace(test);
+
+    // nothing after the trace is stopped is recorded
+    avl_insert(test, 12345);
+    avl_delete(test, 12345);
+
+    printf("Checking the trace reads back...\n");
+    size_t count;
+    trace_record* records = bst_trace_load(path, &count);
+    assert(records && count == (size_t) n);
+    for (int i = 0; i < n; i++)
+        assert(records[i].op == expected[i].op && records[i].arg == expected[i].arg);
+
+    printf("Checking a replay rebuilds the same tree...\n");
+    bst* replayed = avl_create();
+    for (size_t i = 0; i < count; i++) {
+        if (records[i].op == TRACE_INSERT)
+            avl_insert(replayed, records[i].arg);
+        else if (records[i].op == TRACE_DELETE)
+            avl_delete(replayed, records[i].arg);
+    }
+
+    assert(replayed->length == test->length);
+    for (int i = 1; i <= test->length; i++)
+        assert(avl_index(replayed, i)->value == avl_index(test, i)->value);
+
+    remove(path);
+    assert(!bst_trace_load(path, &count) && count == 0);
+
+    printf("Passed\n");
+
+    free(expected);
+    free(records);
+    avl_clear_destroy(test);
+    avl_clear_destroy(replayed);
+    return 0;
+}
+
+
+static void _record_shape(bstnode* head, int* values, int* balances, int* count)
+{
+    // the pre-order keys and balance factors, which pin down the shape
+    if (!head) return;
+
+    values[*count] = head->value;
+    balances[(*count)++] = head->balance_factor;
+    _record_shape(head->left, values, balances, count);
+    _record_shape(head->right, values, balances, count);
+}
+
+
+static void _check_compacted(bst* tree, const int* values, const int* balances)
+{
+    // the shape is unchanged, and the nodes are laid out in key order
+    int* after_values = malloc(sizeof(int) * (tree->length + tree->dead + 1));
+    int* after_balances = malloc(sizeof(int) * (tree->length + tree->dead + 1));
+    int count = 0;
+
+    _record_shape(tree->head, after_values, after_balances, &count);
+    assert(count == tree->length + tree->dead);
+    for (int i = 0; i < count; i++)
+        assert(after_values[i] == values[i] && after_balances[i] == balances[i]);
+
+    for (bstnode* node = bst_node_min(tree->head); node && bst_node_next(node); node = bst_node_next(node))
+        assert((char*) bst_node_next(node) - (char*) node == (long) bst_node_size(tree));
+
+    check_bst_ordering(tree);
+    check_parent_links(tree->head);
+    check_extremes(tree);
+    assert(check_subtree_ranks(tree->head) == tree->length);
+    assert(check_balance_factors(tree->head) == tree->height);
+    check_bst_indexing(tree);
+
+    free(after_values);
+    free(after_balances);
+}
+
+
+int compact_tests(int n)
+{
+    bst* test = avl_create_augmented((bst_monoid[]) {BST_MONOID_SUM(bst_lift_key)}, 1);
+    char* present = calloc(n, 1);
+    int* values = malloc(sizeof(int) * n);
+    int* balances = malloc(sizeof(int) * n);
+    avl_stats stats;
+
+    avl_enable_hash(test);
+    avl_set_lazy_delete(test, 0.25, 4);
+
+    srand(time(NULL));
+    printf("Aging a tree...\n");
+    for (int i = 0; i < 10 * n; i++) {
+        int x = rand() % n;
+        if (rand() % 3) {
+            avl_insert(test, x);
+            present[x] = 1;
+        } else {
+            avl_delete(test, x);
+            present[x] = 0;
+        }
+    }
+
+    printf("Checking a full compaction keeps the tree intact...\n");
+    int count = 0;
+    _record_shape(test->head, values, balances, &count);
+    bst_aggregate total = avl_range_aggregate(test, 0, n, 0);
+
+    avl_compact(test);
+    _check_compacted(test, values, balances);
+    assert(test->arenas && !test->arenas->next && !test->relocating);
+    assert(avl_range_aggregate(test, 0, n, 0) == total);
+
+    avl_memory_stats(test, &stats, 0);
+    assert(stats.arena_nodes == test->length + test->dead);
+
+    for (int x = 0; x < n; x++) {
+        bstnode* node = avl_search(test, x);
+        assert(present[x] ? node && node->value == x : !node);
+    }
+
+    printf("Checking an incremental compaction interleaved with updates...\n");
+    bst_arena* first = test->arenas;
+    int steps = 0;
+    while (avl_compact_incremental(test, 16)) {
+        int x = rand() % n;
+        if (rand() % 2) {
+            avl_insert(test, x);
+            present[x] = 1;
+        } else {
+            avl_delete(test, x);
+            present[x] = 0;
+        }
+
+        if (steps++ % 50 == 0) {
+            check_parent_links(test->head);
+            check_extremes(test);
+            assert(check_subtree_ranks(test->head) == test->length);
+        }
+    }
+
+    for (int x = 0; x < n; x++) {
+        bstnode* node = avl_search(test, x);
+        assert(present[x] ? node && node->value == x : !node);
+    }
+
+    // each arena's live count matches the nodes still in it, and one left
+    // with none has been released
+    for (bst_arena* arena = test->arenas; arena; arena = arena->next) {
+        size_t inside = 0;
+        for (bstnode* node = bst_node_min(test->head); node; node = bst_node_next(node))
+            inside += bst_arena_contains(arena, node);
+
+        assert(inside == arena->live && inside > 0);
+        assert(arena == test->arenas || arena == first);
+    }
+
+    printf("Checking a second full compaction leaves one arena...\n");
+    count = 0;
+    _record_shape(test->head, values, balances, &count);
+    avl_compact(test);
+    _check_compacted(test, values, balances);
+    assert(test->arenas && !test->arenas->next);
+
+    // and that emptying the tree releases it
+    for (int x = 0; x < n; x++)
+        avl_delete(test, x);
+    avl_set_lazy_delete(test, 0, 0);
+    avl_insert(test, 0);
+    avl_delete(test, 0);
+    assert(test->length == 0 && !test->head && !test->arenas);
+
+    printf("Passed\n");
+
+    free(present);
+    free(values);
+    free(balances);
+    avl_clear_destroy(test);
+    return 0;
+}
+
+
+int weighted_tests(int n)
+{
+    bst* test = avl_create_weighted();
+    bst_aggregate* weights = calloc(n, sizeof(bst_aggregate));
+    avl_rng rng;
+
+    avl_rng_seed(&rng, time(NULL));
+    assert(!avl_sample(test, &rng) && !avl_sample_weighted(test, &rng));
+    assert(!avl_select_by_weight(test, 0));
+
+    srand(time(NULL));
+    printf("Checking weighted selection through inserts, updates and deletes...\n");
+    for (int i = 0; i < 4 * n; i++) {
+        int x = rand() % n;
+        int op = rand() % 4;
+
+        // some weights are zero, and must never be selected
+        if (op < 3) {
+            bst_aggregate weight = (rand() % 5) ? rand() % 1000 : 0;
+            avl_insert_payload(test, x, weight);
+            weights[x] = weight;
+        } else if (avl_delete(test, x)) {
+            weights[x] = 0;
+        }
+
+        // lazily deleted nodes drop out of the weights as well
+        if (i == 2 * n)
+            avl_set_lazy_delete(test, 0.25, 4);
+
+        if (i % (n / 2) == 0) {
+            bst_aggregate total = 0;
+            for (int y = 0; y < n; y++) {
+                assert(avl_weighted_rank(test, y) == total);
+                if (weights[y]) {
+                    assert(avl_select_by_weight(test, total)->value == y);
+                    assert(avl_select_by_weight(test, total + weights[y] - 1)->value == y);
+                }
+                total += weights[y];
+            }
+
+            assert(avl_total_weight(test) == total);
+            assert(!avl_select_by_weight(test, total) && !avl_select_by_weight(test, -1));
+        }
+    }
+
+    printf("Checking samples follow the weights...\n");
+    bst* small = avl_create_weighted();
+    for (int x = 0; x < 4; x++)
+        avl_insert_payload(small, x, x);
+
+    int counts[4] = {0};
+    int draws = 600000;
+    for (int i = 0; i < draws; i++)
+        counts[avl_sample_weighted(small, &rng)->value]++;
+
+    // weights 0 to 3 out of 6, each well within 1% of its share
+    assert(counts[0] == 0);
+    for (int x = 1; x < 4; x++)
+        assert(abs(counts[x] - draws * x / 6) < draws / 100);
+
+    memset(counts, 0, sizeof(counts));
+    for (int i = 0; i < draws; i++)
+        counts[avl_sample(small, &rng)->value]++;
+    for (int x = 0; x < 4; x++)
+        assert(abs(counts[x] - draws / 4) < draws / 100);
+
+    printf("Passed\n");
+
+    free(weights);
+    avl_clear_destroy(small);
+    avl_clear_destroy(test);
+    return 0;
+}
+
+
+int cache_tests(int n)
+{
+    // a cache much smaller than the hot keys, so entries are evicted too
+    bst* test = avl_create();
+    char* present = calloc(n, 1);
+    int hot = n / 20;
+    avl_stats stats;
+
+    avl_enable_cache(test, 64);
+    assert(test->cache->set_count * BST_CACHE_WAYS == 64);
+    avl_memory_stats(test, &stats, 0);
+    assert(stats.cache_bytes > 0);
+    assert(((size_t) test->cache->sets) % BST_CACHE_LINE == 0);
+
+    srand(time(NULL));
+    printf("Checking cached searches and ranks through inserts and deletes...\n");
+    for (int i = 0; i < 20 * n; i++) {
+        bst_key x = (rand() % 10) ? rand() % hot : rand() % n;
+        int op = rand() % 8;
+
+        if (op < 2) {
+            avl_insert(test, x);
+            present[x] = 1;
+        } else if (op == 2) {
+            avl_delete(test, x);
+            present[x] = 0;
+        } else if (op == 3) {
+            if (avl_pop_min(test, &x)) present[x] = 0;
+        } else if (op < 6) {
+            bstnode* node = avl_search(test, x);
+            assert(present[x] ? node && node->value == x : !node);
+        } else {
+            assert(avl_get_index(test, x) == bst_get_index(test, x));
+        }
+
+        // lazy deletes, then the exact-match index and compaction, which
+        // moves every cached node
+        if (i == 5 * n)
+            avl_set_lazy_delete(test, 0.25, 4);
+        if (i == 10 * n)
+            avl_enable_hash(test);
+        if (i % (4 * n) == 0)
+            avl_compact(test);
+
+        if (i % 1000 == 0) {
+            for (int y = 0; y < n; y++) {
+                bstnode* node = avl_search(test, y);
+                assert(present[y] ? node && node->value == y : !node);
+                assert(avl_get_index(test, y) == bst_get_index(test, y));
+            }
+        }
+    }
+
+    assert(test->cache->hits > 0 && test->cache->misses > 0);
+    assert(bst_cache_hit_rate(test->cache) > 0 && bst_cache_hit_rate(test->cache) < 1);
+
+    printf("Checking cached ranks follow the rotations of a growing tree...\n");
+    avl_clear_destroy(test);
+    test = avl_create();
+    avl_enable_cache(test, 64);
+    for (int x = 0; x < n; x++)
+        avl_insert(test, 2 * x + 1);
+    for (int x = 0; x < n; x++) {
+        for (int y = 0; y < 64; y++)
+            assert(avl_get_index(test, 2 * y + 1) == bst_get_index(test, 2 * y + 1));
+        avl_insert(test, 2 * x);
+    }
+
+    printf("Checking a hot set that fits is served from the cache...\n");
+    avl_enable_cache(test, 1024);
+    for (int i = 0; i < 20 * n; i++) {
+        bst_key x = rand() % 256;
+        assert(avl_search(test, x)->value == x);
+    }
+    assert(bst_cache_hit_rate(test->cache) > 0.9);
+
+    avl_disable_cache(test);
+    assert(!test->cache);
+    assert(avl_get_index(test, 1) == 2);
+
+    printf("Passed\n");
+
+    free(present);
+    avl_clear_destroy(test);
+    return 0;
+}
+
+
+int wide_key_tests(int n)
+{
+    // only meaningful with BST_64BIT (see nodes.h); elsewhere the keys would
+    // be truncated.
+#ifndef BST_64BIT
+    printf("Skipped %d wide keys: keys are %zu bytes\n", n, sizeof(bst_key));
+    return 0;
+#else
+    const char* path = "avl-test-wide.trace";
+    bst* test = avl_create();
+    bst_key step = (bst_key) 1 << 33;
+
+    // keys spaced 2^33 apart, centered on zero, inserted in a random order
+    int* order = malloc(sizeof(int) * n);
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+
+    srand(time(NULL));
+    for (int i = n - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    assert(avl_start_trace(test, path));
+
+    printf("Inserting keys beyond 32 bits...\n");
+    for (int i = 0; i < n; i++)
+        assert(avl_insert(test, (order[i] - n / 2) * step + 7));
+
+    avl_stop_trace(test);
+    check_balance_factors(test->head);
+    assert(check_subtree_ranks(test->head) == test->length);
+
+    printf("Checking order and ranks...\n");
+    for (int i = 0; i < n; i++) {
+        bst_key key = (i - n / 2) * step + 7;
+        bst_size rank;
+
+        assert(avl_index(test, i + 1)->value == key);
+        assert(avl_get_index(test, key) == i + 1);
+        assert(!avl_search(test, key + ((bst_key) 1 << 32)));
+
+        bstnode* node = avl_lower_bound(test, key - step / 2, &rank);
+        assert(node->value == key && rank == i + 1);
+    }
+
+    printf("Checking a trace keeps the full keys...\n");
+    size_t count;
+    trace_record* records = bst_trace_load(path, &count);
+    assert(records && count == (size_t) n);
+    for (int i = 0; i < n; i++)
+        assert(records[i].op == TRACE_INSERT && records[i].arg == (order[i] - n / 2) * step + 7);
+
+    remove(path);
+
+    printf("Passed\n");
+
+    free(order);
+    free(records);
+    avl_clear_destroy(test);
+    return 0;
+#endif
+}
+
+
 int main(int argc, char **argv)
 {
 
@@ -343,6 +1382,34 @@ int main(int argc, char **argv)
         rotation_stress(10000);
     else if (argc > 1 && !strcmp(argv[1], "rot"))
         double_rot();
+    else if (argc > 1 && !strcmp(argv[1], "delete"))
+        delete_stress(10000);
+    else if (argc > 1 && !strcmp(argv[1], "aggregate"))
+        aggregate_tests(10000);
+    else if (argc > 1 && !strcmp(argv[1], "batch"))
+        batch_tests(10000);
+    else if (argc > 1 && !strcmp(argv[1], "searchmany"))
+        search_many_tests(10000);
+    else if (argc > 1 && !strcmp(argv[1], "neighbors"))
+        neighbor_tests(2000);
+    else if (argc > 1 && !strcmp(argv[1], "memory"))
+        memory_tests(10000);
+    else if (argc > 1 && !strcmp(argv[1], "pq"))
+        priority_queue_tests(10000);
+    else if (argc > 1 && !strcmp(argv[1], "lazy"))
+        lazy_delete_tests(2000);
+    else if (argc > 1 && !strcmp(argv[1], "hash"))
+        hash_tests(5000);
+    else if (argc > 1 && !strcmp(argv[1], "trace"))
+        trace_tests(20000);
+    else if (argc > 1 && !strcmp(argv[1], "compact"))
+        compact_tests(5000);
+    else if (argc > 1 && !strcmp(argv[1], "weighted"))
+        weighted_tests(2000);
+    else if (argc > 1 && !strcmp(argv[1], "wide"))
+        wide_key_tests(5000);
+    else if (argc > 1 && !strcmp(argv[1], "cache"))
+        cache_tests(5000);
 
     return 0;
 }
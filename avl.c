@@ -10,8 +10,18 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <math.h>
+#include <limits.h>
 #include "avl.h"
 
+// The rebalancing code is pretty chatty when debugging, but the output
+// swamps everything else (and the timings) otherwise.
+#ifdef AVL_DEBUG
+#define avl_debug(...) printf(__VA_ARGS__)
+#else
+#define avl_debug(...)
+#endif
+
 void avl_rotate_left(bst* tree, bstnode* center)
 {
     bst_rotate_left(tree, center);
@@ -32,35 +42,38 @@ int avl_rebalance(bst* tree, bstnode* rebalance_node, int direction)
         return 0;
     }
 
-    printf("pivot node is %d (%d)\n", pivot->value, pivot->balance_factor);
+    avl_debug("pivot node is " BST_KEY_FMT " (%d)\n", pivot->value, pivot->balance_factor);
 
     // special case for deletion when the pivot is already balanced
     if (pivot->balance_factor == EVEN) {
-        printf("special case 3!\n");
+        avl_debug("special case 3!\n");
 
-        // single rotation
+        // single rotation. The rebalance node stays heavy towards the
+        // pivot's old inner subtree, and the pivot ends up leaning the
+        // other way.
         if (direction == LEFT)  {
-            printf("rotating right!\n");
+            avl_debug("rotating right!\n");
             avl_rotate_right(tree, rebalance_node);
-            pivot->balance_factor = rebalance_node->balance_factor;
         }
         else {
-            printf("rotating left!\n");
+            avl_debug("rotating left!\n");
             avl_rotate_left(tree, rebalance_node);
-            pivot->balance_factor = rebalance_node->balance_factor;
         }
+
+        rebalance_node->balance_factor = direction;
+        pivot->balance_factor = REVERSE_DIRECTION(direction);
     }
 
     else if (pivot->balance_factor == direction) {
         // single rotation
         if (direction == LEFT)  {
-            printf("rotating right!\n");
+            avl_debug("rotating right!\n");
             avl_rotate_right(tree, rebalance_node);
             rebalance_node->balance_factor = EVEN;
             pivot->balance_factor = EVEN;
         }
         else {
-            printf("rotating left!\n");
+            avl_debug("rotating left!\n");
             avl_rotate_left(tree, rebalance_node);
             rebalance_node->balance_factor = EVEN;
             pivot->balance_factor = EVEN;
@@ -75,7 +88,7 @@ int avl_rebalance(bst* tree, bstnode* rebalance_node, int direction)
         }
 
         if (direction == LEFT) {
-            printf("Double rotation, left then right!\n");
+            avl_debug("Double rotation, left then right!\n");
             avl_rotate_left(tree, pivot);
             avl_rotate_right(tree, rebalance_node);
 
@@ -93,7 +106,7 @@ int avl_rebalance(bst* tree, bstnode* rebalance_node, int direction)
                 second_pivot->balance_factor = 0;
         }
         else {
-            printf("Double rotation, right then left\n");
+            avl_debug("Double rotation, right then left\n");
             avl_rotate_right(tree, pivot);
             avl_rotate_left(tree, rebalance_node);
 
@@ -112,7 +125,7 @@ int avl_rebalance(bst* tree, bstnode* rebalance_node, int direction)
         }
     }
 
-    printf("end of rebalance\n");
+    avl_debug("end of rebalance\n");
     return 1;
 }
 
@@ -123,97 +136,301 @@ bst* avl_create(void)
 }
 
 
-void avl_node_delete(bst* tree, bstnode* todelete, node** path)
+bst* avl_create_augmented(const bst_monoid* monoids, int count)
 {
-    node* rotated_nodes = init_update_tracker();
-    bst_node_delete(tree, todelete, &rotated_nodes);
+    return bst_create_augmented(monoids, count);
+}
 
-    // we need to walk back up the path, rotating as needed to
-    // fix the balance.
-    node* stack_head = rotated_nodes;
-    node* current = rotated_nodes;
 
-    while(current) {
-        bstnode* rebalance_node = current->treenode;
+void avl_node_delete(bst* tree, bstnode* todelete)
+{
+    avl_node_unlink(tree, todelete);
+    bst_free_node(tree, todelete);
+}
+
 
-        // fix the balance of rebalance_node, 
-        // if needed.
-        
-        current = current->next;
+void avl_node_unlink(bst* tree, bstnode* todelete)
+{
+    // removes todelete from the tree, rebalancing, but doesn't free it
+    int direction;
+    bstnode* rebalance_node = bst_node_unlink(tree, todelete, &direction);
+
+    // walk back up the tree from the point where the node was physically
+    // removed, fixing balance factors (and rotating) until the height of
+    // a subtree stops changing.
+    while (rebalance_node) {
+        bstnode* parent = rebalance_node->parent;
+        int parent_direction = (parent && parent->left == rebalance_node) ? LEFT : RIGHT;
+
+        if (!_avl_delete_balancing(tree, rebalance_node, direction)) {
+            return;
+        }
+
+        rebalance_node = parent;
+        direction = parent_direction;
     }
 
-    // once the balance of the nodes rotated have been fixed, everything above
-    // these should remain in the original balance state, and so the balance
-    // correction code in avl_delete can take it from here.
+    // the shrinkage made it all the way past the root
+    tree->height--;
+}
+
 
-    destroy_update_tracker(stack_head);
+void avl_set_lazy_delete(bst* tree, double threshold, int step)
+{
+    // With a positive threshold, deletes only mark nodes dead. Once more than
+    // threshold of the nodes in the tree are dead, each insert or delete also
+    // advances an incremental sweep over the tree by step nodes, physically
+    // removing any dead ones it passes, until it reaches the end.
+    tree->dead_threshold = threshold;
+    tree->compact_step = (step > 0) ? step : AVL_COMPACT_STEP;
 }
 
 
-int avl_delete(bst* tree, int value)
+static bstnode* _avl_first_at_least(bst* tree, bst_key value)
 {
-    node* path_tracker = init_update_tracker();
-    bstnode* todelete = bst_find_node_and_path(tree, value, &path_tracker, -1);
+    // like bst_lower_bound, but dead nodes count too
+    bstnode* current = tree->head;
+    bstnode* found = NULL;
+
+    while (current) {
+        if (current->value >= value) {
+            found = current;
+            current = current->left;
+        } else {
+            current = current->right;
+        }
+    }
+
+    return found;
+}
+
+
+static void _avl_compact_step(bst* tree)
+{
+    if (!tree->dead) {
+        tree->compacting = 0;
+        return;
+    }
+
+    if (!tree->compacting) {
+        if (tree->dead <= tree->dead_threshold * (tree->length + tree->dead))
+            return;
+
+        tree->compacting = 1;
+        tree->compact_cursor = tree->leftmost->value;
+    }
+
+    // The sweep position is kept as a key, rather than a node, so that it
+    // survives whatever the tree has been through since the last step.
+    bstnode* current = _avl_first_at_least(tree, tree->compact_cursor);
+    for (int i=0; current && i<tree->compact_step; i++) {
+        bstnode* next = bst_node_next(current);
+        if (current->dead)
+            avl_node_delete(tree, current);
+
+        current = next;
+    }
+
+    if (current)
+        tree->compact_cursor = current->value;
+    else
+        tree->compacting = 0;
+}
+
+
+static void _avl_trim_extremes(bst* tree)
+{
+    // Physically removing an extreme can expose a run of dead neighbours.
+    // These are removed for real a few at a time, at most compact_step per
+    // operation, so that a pop after a long run of lazy deletes next to it
+    // doesn't pay for all of them at once. Until then, the cached extremes
+    // can be dead, and peeks and pops go around them.
+    int budget = tree->compact_step;
+
+    for (; budget > 0 && tree->leftmost && tree->leftmost->dead; budget--)
+        avl_node_delete(tree, tree->leftmost);
+
+    for (; budget > 0 && tree->rightmost && tree->rightmost->dead; budget--)
+        avl_node_delete(tree, tree->rightmost);
+}
+
+
+static bstnode* _avl_live_min(bst* tree)
+{
+    // With dead nodes still waiting to be trimmed at the extreme, the first
+    // live one is found by its rank, which dead nodes don't count, rather
+    // than by walking over the whole dead run on every peek and pop.
+    bstnode* node = tree->leftmost;
+    return (node && node->dead) ? bst_index(tree, 1) : node;
+}
+
+
+static bstnode* _avl_live_max(bst* tree)
+{
+    bstnode* node = tree->rightmost;
+    return (node && node->dead) ? bst_index(tree, tree->length) : node;
+}
+
+
+static void _avl_remove(bst* tree, bstnode* todelete, int popped)
+{
+    // Popped nodes are always removed for real, as a dead one would only
+    // lengthen the run the next pop has to skip over.
+    if (tree->dead_threshold > 0 && !popped && todelete != tree->leftmost && todelete != tree->rightmost) {
+        // A lazy delete only has to fix the ranks (and aggregates) of the
+        // nodes above, without any rotations.
+        todelete->dead = 1;
+        todelete->rank--;
+        tree->length--;
+        tree->dead++;
+
+        if (tree->cache) {
+            bst_cache_remove(tree->cache, todelete->value);
+            bst_cache_ranks_changed(tree->cache);
+        }
+
+        for (bstnode* current = todelete; current->parent; current = current->parent) {
+            if (current->parent->left == current)
+                current->parent->rank--;
+        }
+
+        bst_update_path_aggregates(tree, todelete);
+    } else {
+        avl_node_delete(tree, todelete);
+    }
+
+    if (tree->dead)
+        _avl_trim_extremes(tree);
+
+    if (tree->dead)
+        _avl_compact_step(tree);
+}
+
+
+int avl_delete(bst* tree, bst_key value)
+{
+    if (tree->trace)
+        bst_trace_record(tree->trace, TRACE_DELETE, value);
+
+    bstnode* todelete = bst_search(tree, value);
 
     if (!todelete) {
-        revert_rank_updates(path_tracker, +1);
         return 0;
     }
 
-    node* search_path_stop = path_tracker;
-    avl_node_delete(tree, todelete, &path_tracker);
+    avl_debug("\n\nBeginning Rebalance for Delete of " BST_KEY_FMT "\n", value);
+    _avl_remove(tree, todelete, 0);
+
+    return 1;
+}
 
-    node* tracker_head = path_tracker; 
 
-    // We'll need to process balance updates for each node that was touched
-    // by the delete, starting at the bottom.
-    int original_balance = -1;
+int avl_delete_at(bst* tree, bst_size rank, bst_key* value)
+{
+    // Deletes the node with the given rank, storing its value in value (if
+    // it isn't NULL). Only one descent is needed, as the ranks are fixed on
+    // the way back up, along with the balance factors.
+    bstnode* todelete = bst_index(tree, rank);
 
-    printf("Tracked nodes...\n");
-    node* temp = path_tracker;
-    while (temp) {
-        printf("%d (%d)\n", temp->treenode->value,
-                temp->treenode->balance_factor);
-        temp = temp->next;
+    if (!todelete) {
+        return 0;
     }
 
-    printf("\n\nBeginning Rebalance for Delete of %d\n", value);
-    while (path_tracker) {
-        // process balance updates (and rotations!)
-        original_balance = path_tracker->treenode->balance_factor;
-        _avl_delete_balancing(tree, path_tracker->treenode, path_tracker->direction);
+    if (value) *value = todelete->value;
+    if (tree->trace)
+        bst_trace_record(tree->trace, TRACE_DELETE, todelete->value);
 
-        path_tracker = path_tracker->next;
+    _avl_remove(tree, todelete, 0);
+
+    return 1;
+}
+
+
+int avl_pop_min(bst* tree, bst_key* value)
+{
+    // The smallest node is cached, so there's no descent at all (unless
+    // dead nodes are still waiting to be trimmed next to it), and the
+    // retrace usually stops after a step or two.
+    bstnode* todelete = _avl_live_min(tree);
+
+    if (!todelete) {
+        return 0;
     }
 
-    destroy_update_tracker(tracker_head);
+    if (value) *value = todelete->value;
+    if (tree->trace)
+        bst_trace_record(tree->trace, TRACE_DELETE, todelete->value);
+
+    _avl_remove(tree, todelete, 1);
 
     return 1;
 }
 
 
-void _avl_delete_balancing(bst* tree, bstnode* rebalance_node, int delete_direction)
+int avl_pop_max(bst* tree, bst_key* value)
+{
+    bstnode* todelete = _avl_live_max(tree);
+
+    if (!todelete) {
+        return 0;
+    }
+
+    if (value) *value = todelete->value;
+    if (tree->trace)
+        bst_trace_record(tree->trace, TRACE_DELETE, todelete->value);
+
+    _avl_remove(tree, todelete, 1);
+
+    return 1;
+}
+
+
+bstnode* avl_peek_min(bst* tree)
+{
+    return _avl_live_min(tree);
+}
+
+
+bstnode* avl_peek_max(bst* tree)
 {
-    // process balance updates (and rotations!)
-    printf("Current rebalance node %d (%d)\n", rebalance_node->value,
+    return _avl_live_max(tree);
+}
+
+
+int _avl_delete_balancing(bst* tree, bstnode* rebalance_node, int delete_direction)
+{
+    // process balance updates (and rotations!). Returns 1 if the height
+    // of the subtree rooted at this position has shrunk, and so the
+    // balance of its parent needs adjusting as well.
+    int shrunk = 1;
+
+    avl_debug("Current rebalance node " BST_KEY_FMT " (%d)\n", rebalance_node->value,
             rebalance_node->balance_factor);
 
-    printf("Delete direction is %d\n", delete_direction);
+    avl_debug("Delete direction is %d\n", delete_direction);
 
     // Update balance factors for rebalance point
     if (rebalance_node->balance_factor == delete_direction) {
         rebalance_node->balance_factor = EVEN;
     } else if (rebalance_node->balance_factor == EVEN) {
         rebalance_node->balance_factor = REVERSE_DIRECTION(delete_direction);
+        shrunk = 0;
     } else if (rebalance_node->balance_factor == REVERSE_DIRECTION(delete_direction)) {
-        printf("we must rebalance!\n");
+        avl_debug("we must rebalance!\n");
+
+        // if the pivot was balanced, the single rotation leaves the
+        // subtree at its original height.
+        bstnode* pivot = BRANCH(REVERSE_DIRECTION(delete_direction), rebalance_node);
+        shrunk = (pivot->balance_factor != EVEN);
+
         int x = avl_rebalance(tree, rebalance_node, REVERSE_DIRECTION(delete_direction));
-        assert(!x);
-        printf("%d\n", x);
+        assert(x == 1);
     }
 
-    printf("Rebalance node final state: %d (%d)\n", rebalance_node->value,
+    avl_debug("Rebalance node final state: " BST_KEY_FMT " (%d)\n", rebalance_node->value,
             rebalance_node->balance_factor);
+
+    return shrunk;
 }
 
 void _avl_insert_balancing(bst* tree, bstnode* rebalance_node, int direction)
@@ -236,12 +453,12 @@ void _avl_insert_balancing(bst* tree, bstnode* rebalance_node, int direction)
 }
 
 
-int avl_delete_slow(bst** tree, int value)
+int avl_delete_slow(bst** tree, bst_key value)
 {
     // a slow (n lg n) version of delete that maintains balance
     // by just rebuilding a new tree without the offending element.
     
-    bstnode* del_node = avl_search(*tree, value);
+    bstnode* del_node = bst_search(*tree, value);
 
     if (!del_node) {
         // the element isn't in the tree, so do nothing
@@ -249,7 +466,7 @@ int avl_delete_slow(bst** tree, int value)
     }
 
     bst* new_tree = bst_create();
-    for (int i=1; i < (*tree)->length+1; i++) {
+    for (bst_size i=1; i < (*tree)->length+1; i++) {
         bstnode* node = bst_index(*tree, i);
         if (node->value != value) {
             avl_insert(new_tree, node->value);
@@ -263,23 +480,50 @@ int avl_delete_slow(bst** tree, int value)
 }
 
 
-int avl_insert(bst* tree, int value)
+int avl_insert(bst* tree, bst_key value)
 {
-    bstnode* newnode = bstnode_create(value);
+    if (tree->trace)
+        bst_trace_record(tree->trace, TRACE_INSERT, value);
+
+    bstnode* newnode = bst_create_node(tree, value);
     newnode->balance_factor = EVEN;
 
-    if (tree->length == 0) {
-        tree->head = newnode;
-        tree->length++;
+    // length only counts live nodes, so a tree can have none left while
+    // dead ones are still linked in
+    if (!tree->head) {
+        bst_node_insert(tree, newnode, NULL);
+        tree->height = 1;
         return 1;
     }
 
     node* path_tracker = init_update_tracker();
     bstnode* insert_location = bst_find_node_and_path(tree, value, &path_tracker, 1);
 
+    if (insert_location && insert_location->dead) {
+        // the value was lazily deleted, so its node is brought back to
+        // life. The ranks on the way down already count it.
+        insert_location->dead = 0;
+        insert_location->rank++;
+        tree->length++;
+        tree->dead--;
+
+        if (tree->cache)
+            bst_cache_ranks_changed(tree->cache);
+
+        if (tree->augment) {
+            BST_PAYLOAD(insert_location) = BST_PAYLOAD(newnode);
+            bst_update_path_aggregates(tree, insert_location);
+        }
+
+        destroy_update_tracker(path_tracker);
+        free(newnode);
+        return 1;
+    }
+
     if (insert_location) {
         revert_rank_updates(path_tracker, -1);
         destroy_update_tracker(path_tracker);
+        free(newnode);
         return 0;
     }
 
@@ -295,6 +539,12 @@ int avl_insert(bst* tree, int value)
 
     bstnode* rebalance_node = (path_tracker) ? path_tracker->treenode : tree->head;
 
+    // if every node up to the root was balanced, the root is about to
+    // lean towards the new node, so the whole tree has grown.
+    if (!path_tracker) {
+        tree->height++;
+    }
+
     int insert_direction = (value < rebalance_node->value) ? LEFT : RIGHT;
 
     // Update balance factors, and rebalance if needed
@@ -312,28 +562,490 @@ int avl_insert(bst* tree, int value)
     _avl_insert_balancing(tree, rebalance_node, insert_direction);
 
     destroy_update_tracker(tracker_head);
-    return 0;
+
+    if (tree->dead)
+        _avl_trim_extremes(tree);
+
+    if (tree->dead)
+        _avl_compact_step(tree);
+
+    return 1;
 }
 
 
-bstnode* avl_search(bst* tree, int value)
+bstnode* avl_search(bst* tree, bst_key value)
 {
+    if (tree->trace)
+        bst_trace_record(tree->trace, TRACE_SEARCH, value);
+
+    if (tree->cache) {
+        bstnode* found = bst_cache_get(tree->cache, value);
+        if (found) return found;
+
+        found = bst_search(tree, value);
+        if (found) bst_cache_put(tree->cache, found, 0);
+        return found;
+    }
+
     return bst_search(tree, value);
 }
 
 
-bstnode* avl_index(bst* tree, int rank)
+void avl_enable_hash(bst* tree)
+{
+    // Indexes every node by key, after which avl_search (and every other
+    // exact-match lookup) is a hash probe rather than a descent. This costs
+    // at least 32 bytes per node, as the table is kept at most half full.
+    if (tree->hash) return;
+
+    tree->hash = bst_hash_create(tree->length + tree->dead);
+    for (bstnode* current = bst_node_min(tree->head); current; current = bst_node_next(current))
+        bst_hash_put(tree->hash, current);
+}
+
+
+void avl_disable_hash(bst* tree)
+{
+    bst_hash_destroy(tree->hash);
+    tree->hash = NULL;
+}
+
+
+void avl_enable_cache(bst* tree, size_t entries)
+{
+    // Puts a cache of at least entries entries (or a default size, if
+    // entries is 0) in front of avl_search and avl_get_index, replacing any
+    // cache the tree already has. It starts out empty, and fills with the
+    // keys those look up.
+    bst_cache_destroy(tree->cache);
+    tree->cache = bst_cache_create(entries);
+}
+
+
+void avl_disable_cache(bst* tree)
+{
+    bst_cache_destroy(tree->cache);
+    tree->cache = NULL;
+}
+
+
+void avl_search_many(bst* tree, const bst_key* values, size_t n, bstnode** out)
+{
+    // out[i] is the result of avl_search(tree, values[i]). Use
+    // bst_search_many directly to pick a different group size.
+    if (tree->trace) {
+        for (size_t i=0; i<n; i++)
+            bst_trace_record(tree->trace, TRACE_SEARCH, values[i]);
+    }
+
+    bst_search_many(tree, values, n, out, AVL_SEARCH_GROUP);
+}
+
+
+int avl_start_trace(bst* tree, const char* path)
+{
+    // Starts recording every insert, delete, search, index and get_index
+    // made through the avl_ functions to the file at path (replacing any
+    // trace already being recorded). Returns 0 if the file can't be created.
+    avl_stop_trace(tree);
+
+    tree->trace = bst_trace_open(path);
+    return tree->trace != NULL;
+}
+
+
+void avl_stop_trace(bst* tree)
+{
+    bst_trace_close(tree->trace);
+    tree->trace = NULL;
+}
+
+
+/*
+ * The ordered-neighbor queries each find their node, and its rank, in a
+ * single descent. The rank may be NULL if it isn't needed. When no node
+ * qualifies they return NULL, with the rank set to where the node would be
+ * (length + 1 for the bounds and successor, 0 for the predecessor).
+ */
+bstnode* avl_lower_bound(bst* tree, bst_key value, bst_size* rank)
+{
+    return bst_lower_bound(tree, value, rank);
+}
+
+
+bstnode* avl_upper_bound(bst* tree, bst_key value, bst_size* rank)
+{
+    return bst_upper_bound(tree, value, rank);
+}
+
+
+bstnode* avl_predecessor(bst* tree, bst_key value, bst_size* rank)
+{
+    return bst_predecessor(tree, value, rank);
+}
+
+
+bstnode* avl_successor(bst* tree, bst_key value, bst_size* rank)
 {
+    return bst_successor(tree, value, rank);
+}
+
+
+bstnode* avl_nearest(bst* tree, bst_key value, bst_size* rank)
+{
+    return bst_nearest(tree, value, rank);
+}
+
+
+bstnode* avl_next(bstnode* current)
+{
+    return bst_node_next_live(current);
+}
+
+
+bstnode* avl_prev(bstnode* current)
+{
+    return bst_node_prev_live(current);
+}
+
+
+bstnode* avl_index(bst* tree, bst_size rank)
+{
+    if (tree->trace)
+        bst_trace_record(tree->trace, TRACE_INDEX, rank);
+
     return bst_index(tree, rank);
 }
 
 
-int avl_get_index(bst* tree, int value)
+bst_size avl_get_index(bst* tree, bst_key value)
 {
+    if (tree->trace)
+        bst_trace_record(tree->trace, TRACE_GET_INDEX, value);
+
+    if (tree->cache) {
+        bstnode* found;
+        bst_size index = bst_cache_get_rank(tree->cache, value, &found);
+        if (index) return index;
+
+        if (found)
+            index = bst_node_index(found);
+        else
+            found = bst_search_index(tree, value, &index);
+
+        if (found) bst_cache_put(tree->cache, found, index);
+        return index;
+    }
+
     return bst_get_index(tree, value);
 }
 
 
+void avl_index_batch(bst* tree, const bst_size* ranks, size_t k, bstnode** out)
+{
+    // answers all k index queries with a single shared descent (or an
+    // in-order pass, for very large batches). out[i] corresponds to ranks[i].
+    if (tree->trace) {
+        for (size_t i=0; i<k; i++)
+            bst_trace_record(tree->trace, TRACE_INDEX, ranks[i]);
+    }
+
+    bst_index_batch(tree, ranks, k, out);
+}
+
+
+void avl_get_index_batch(bst* tree, const bst_key* values, size_t k, bst_size* out)
+{
+    if (tree->trace) {
+        for (size_t i=0; i<k; i++)
+            bst_trace_record(tree->trace, TRACE_GET_INDEX, values[i]);
+    }
+
+    bst_get_index_batch(tree, values, k, out);
+}
+
+
+int avl_insert_payload(bst* tree, bst_key value, bst_aggregate payload)
+{
+    // inserts value if it isn't already present, and either way sets
+    // its payload.
+    int rc = avl_insert(tree, value);
+    bst_set_payload(tree, bst_search(tree, value), payload);
+
+    return rc;
+}
+
+
+bst_aggregate avl_range_aggregate(bst* tree, bst_key lo, bst_key hi, int monoid)
+{
+    return bst_range_aggregate(tree, lo, hi, monoid);
+}
+
+
+bst* avl_create_weighted(void)
+{
+    // Weights are set with avl_insert_payload (which also updates the
+    // weight of a key already present), and are kept summed over every
+    // subtree through rotations, like the rank. They must not be negative.
+    bst_monoid weight_sum = BST_MONOID_SUM(bst_lift_payload);
+    return avl_create_augmented(&weight_sum, 1);
+}
+
+
+bst_aggregate avl_total_weight(bst* tree)
+{
+    return bst_subtree_aggregate(tree, tree->head, AVL_WEIGHT);
+}
+
+
+bst_aggregate avl_weighted_rank(bst* tree, bst_key value)
+{
+    // the total weight of the keys less than value, the weighted analogue
+    // of avl_get_index
+    bst_aggregate before = 0;
+    bstnode* current = tree->head;
+
+    while (current) {
+        if (current->value < value) {
+            before += bst_subtree_aggregate(tree, current->left, AVL_WEIGHT);
+            if (!current->dead) before += BST_PAYLOAD(current);
+            current = current->right;
+        } else {
+            current = current->left;
+        }
+    }
+
+    return before;
+}
+
+
+bstnode* avl_select_by_weight(bst* tree, bst_aggregate weight)
+{
+    // Returns the node whose share of the cumulative weight (taking the
+    // keys in order) covers weight, for weight in [0, avl_total_weight).
+    // This is the weighted analogue of avl_index, counting from zero, and
+    // never returns a node of weight zero (or a dead one).
+    if (weight < 0 || weight >= avl_total_weight(tree))
+        return NULL;
+
+    bstnode* current = tree->head;
+    while (current) {
+        bst_aggregate left = bst_subtree_aggregate(tree, current->left, AVL_WEIGHT);
+        bst_aggregate mine = (current->dead) ? 0 : BST_PAYLOAD(current);
+
+        if (weight < left) {
+            current = current->left;
+        } else if (weight < left + mine) {
+            return current;
+        } else {
+            weight -= left + mine;
+            current = current->right;
+        }
+    }
+
+    return NULL;
+}
+
+
+void avl_rng_seed(avl_rng* rng, uint64_t seed)
+{
+    rng->state = seed;
+}
+
+
+uint64_t avl_rng_next(avl_rng* rng)
+{
+    uint64_t z = (rng->state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+
+static uint64_t _avl_rng_below(avl_rng* rng, uint64_t bound)
+{
+    // A uniform integer in [0, bound), from the high half of a 128 bit
+    // product, redrawing the few values that would bias it (Lemire's
+    // method), so that it costs no division in the common case.
+    __uint128_t product = (__uint128_t) avl_rng_next(rng) * bound;
+    uint64_t low = (uint64_t) product;
+
+    if (low < bound) {
+        uint64_t threshold = -bound % bound;
+        while (low < threshold) {
+            product = (__uint128_t) avl_rng_next(rng) * bound;
+            low = (uint64_t) product;
+        }
+    }
+
+    return product >> 64;
+}
+
+
+bstnode* avl_sample_weighted(bst* tree, avl_rng* rng)
+{
+    // a key drawn with probability proportional to its weight, or NULL if
+    // the weights are all zero
+    bst_aggregate total = avl_total_weight(tree);
+    if (total <= 0) return NULL;
+
+    return avl_select_by_weight(tree, _avl_rng_below(rng, total));
+}
+
+
+bstnode* avl_sample(bst* tree, avl_rng* rng)
+{
+    // a key drawn uniformly at random, or NULL if the tree is empty
+    if (!tree->length) return NULL;
+
+    return avl_index(tree, _avl_rng_below(rng, tree->length) + 1);
+}
+
+
+static size_t _estimate_malloc_overhead(size_t size)
+{
+    // Assumes a glibc-style allocator, with an 8 byte chunk header,
+    // 16 byte alignment and a 32 byte minimum chunk.
+    size_t chunk = (size + 8 + 15) & ~((size_t) 15);
+    if (chunk < 32) chunk = 32;
+
+    return chunk - size;
+}
+
+
+static void _measure_depths(bstnode* head, int depth, long long* total_depth, int* height)
+{
+    if (head == NULL) return;
+
+    *total_depth += depth;
+    if (depth > *height)
+        *height = depth;
+
+    _measure_depths(head->left, depth + 1, total_depth, height);
+    _measure_depths(head->right, depth + 1, total_depth, height);
+}
+
+
+void avl_memory_stats(bst* tree, avl_stats* stats, int exact)
+{
+    // Everything but the average search depth is maintained as the tree is
+    // modified, so this is O(1) unless an exact measurement is requested,
+    // which walks the whole tree. Without one, the average depth is
+    // estimated as that of a perfectly balanced tree of the same size.
+    size_t node_size = bst_node_size(tree);
+    bst_size nodes = tree->length + tree->dead;
+
+    // arena nodes have no allocator overhead of their own, but the slots
+    // of freed ones are wasted until the whole arena is released
+    size_t arena_overhead = 0;
+    stats->arena_nodes = 0;
+    for (bst_arena* arena = tree->arenas; arena; arena = arena->next) {
+        stats->arena_nodes += arena->live;
+        arena_overhead += (arena->capacity - arena->live) * node_size
+            + _estimate_malloc_overhead(arena->capacity * node_size)
+            + sizeof(bst_arena) + _estimate_malloc_overhead(sizeof(bst_arena));
+    }
+
+    stats->nodes = nodes;
+    stats->node_bytes = node_size * nodes;
+    stats->aux_bytes = sizeof(bst) + ((tree->augment) ? sizeof(bst_augment) : 0);
+    stats->index_bytes = bst_hash_bytes(tree->hash);
+    stats->cache_bytes = bst_cache_bytes(tree->cache);
+    stats->tracker_peak_bytes = tracker_peak_bytes();
+    stats->overhead_bytes = _estimate_malloc_overhead(node_size) * (nodes - stats->arena_nodes)
+        + arena_overhead
+        + _estimate_malloc_overhead(sizeof(bst))
+        + ((tree->augment) ? _estimate_malloc_overhead(sizeof(bst_augment)) : 0)
+        + ((tree->hash) ? _estimate_malloc_overhead(sizeof(bst_hash))
+                + _estimate_malloc_overhead(stats->index_bytes - sizeof(bst_hash)) : 0)
+        + ((tree->cache) ? _estimate_malloc_overhead(sizeof(bst_cache))
+                + _estimate_malloc_overhead(stats->cache_bytes - sizeof(bst_cache)) : 0);
+
+    stats->height = tree->height;
+    stats->height_bound = (int) (1.4405 * log2(nodes + 2) - 0.3277);
+
+    // The estimate is the average depth of a perfect tree of as many nodes,
+    // counting the root as depth 1: with h = lg(n + 1) levels, the depths
+    // sum to (h - 1)(n + 1) + 1.
+    double levels = log2((double) nodes + 1);
+    stats->average_depth = (nodes) ? ((levels - 1) * (nodes + 1) + 1) / nodes : 0;
+    stats->exact = exact;
+
+    if (exact && nodes) {
+        long long total_depth = 0;
+        int height = 0;
+        _measure_depths(tree->head, 1, &total_depth, &height);
+
+        stats->height = height;
+        stats->average_depth = (double) total_depth / nodes;
+    }
+}
+
+
+int avl_compact_incremental(bst* tree, int budget)
+{
+    // Moves up to budget nodes (at least one) into a contiguous arena, in
+    // key order, without changing the shape of the tree. The first call
+    // starts a pass, sizing a new arena for every node in the tree, and
+    // later calls pick up where it left off, so the tree can be modified in
+    // between. Returns 1 while the pass has nodes left to move.
+    //
+    // Nodes inserted behind the cursor after the pass began stay where
+    // they are, and the arena of a pass that finished early keeps its
+    // unused slots until all of its nodes are freed. As nodes are moved,
+    // any pointers to them held outside the tree are invalidated.
+    bstnode* current;
+
+    if (!tree->relocating) {
+        if (!tree->head) return 0;
+
+        tree->arenas = bst_arena_create(bst_node_size(tree), tree->length + tree->dead,
+                tree->arenas);
+        tree->relocating = 1;
+        current = bst_node_min(tree->head);
+    } else {
+        current = _avl_first_at_least(tree, tree->relocate_cursor);
+    }
+
+    bst_arena* arena = tree->arenas;
+    for (int i=0; current && (i < budget || i == 0); i++) {
+        bstnode* dest = bst_arena_alloc(arena);
+        if (!dest) break;
+
+        bstnode* next = bst_node_next(current);
+        bst_node_relocate(tree, current, dest);
+        current = next;
+    }
+
+    if (current && arena->used < arena->capacity) {
+        tree->relocate_cursor = current->value;
+        return 1;
+    }
+
+    // the slots that weren't needed will never be handed out, so the arena
+    // counts as full from here on, and can be released once it's empty
+    arena->capacity = arena->used;
+    tree->relocating = 0;
+    if (!arena->live) {
+        tree->arenas = arena->next;
+        bst_arena_destroy(arena);
+    }
+
+    return 0;
+}
+
+
+void avl_compact(bst* tree)
+{
+    // Relocates the whole tree into a single arena in key order (or, if an
+    // incremental pass is underway, finishes that pass). In-order scans
+    // then walk memory sequentially, and the nodes of a search share far
+    // fewer pages. The old nodes are freed, and an older arena is released
+    // once everything in it has moved.
+    while (avl_compact_incremental(tree, INT_MAX));
+}
+
+
 void avl_clear(bst* tree)
 {
     bst_clear(tree);
@@ -13,22 +13,126 @@
 #include <assert.h>
 #include "bst.h"
 #include "tracker.h"
+#include "augment.h"
+#include "hash.h"
+#include "cache.h"
+#include "trace.h"
+#include "arena.h"
 
+// the number of searches avl_search_many keeps in flight at once
+#ifndef AVL_SEARCH_GROUP
+#define AVL_SEARCH_GROUP 16
+#endif
+
+// the default number of nodes each operation sweeps over while compacting
+// away lazily deleted nodes
+#ifndef AVL_COMPACT_STEP
+#define AVL_COMPACT_STEP 8
+#endif
+
+
+// In a tree from avl_create_weighted, the payload of each node is its weight,
+// and this monoid sums them
+#define AVL_WEIGHT 0
+
+// the state of the generator used for sampling (splitmix64)
+typedef struct AVLRng {
+    uint64_t state;
+} avl_rng;
+
+typedef struct AVLStats {
+    bst_size nodes;
+
+    // bytes requested for the nodes themselves, and for the tree object
+    // (and its augmentation, if any)
+    size_t node_bytes;
+    size_t aux_bytes;
+
+    // bytes used by the exact-match index, if the tree has one
+    size_t index_bytes;
+
+    // bytes used by the front cache of hot keys, if the tree has one
+    size_t cache_bytes;
+
+    // the most bytes of path trackers ever live at once, process wide
+    size_t tracker_peak_bytes;
+
+    // estimated bytes lost to allocator headers and rounding, and to arena
+    // slots whose nodes have been freed
+    size_t overhead_bytes;
+
+    // the nodes that avl_compact has relocated into arenas
+    bst_size arena_nodes;
+
+    // the height of the tree (in nodes), and the most an AVL tree of the
+    // same size could have
+    int height;
+    int height_bound;
+
+    // the average number of nodes visited by a successful search
+    double average_depth;
+
+    // whether height and average_depth were measured, or are estimates
+    int exact;
+} avl_stats;
 
 bst* avl_create(void);
+bst* avl_create_augmented(const bst_monoid* monoids, int count);
 
-int avl_insert(bst* tree, int value);
-int avl_delete(bst* tree, int value);
-int avl_delete_slow(bst** tree, int value);
-bstnode* avl_search(bst* tree, int value);
-bstnode* avl_index(bst* tree, int index);
-int avl_get_index(bst* tree, int value);
+int avl_insert(bst* tree, bst_key value);
+int avl_delete(bst* tree, bst_key value);
+int avl_delete_slow(bst** tree, bst_key value);
+int avl_delete_at(bst* tree, bst_size rank, bst_key* value);
+void avl_set_lazy_delete(bst* tree, double threshold, int step);
+int avl_pop_min(bst* tree, bst_key* value);
+int avl_pop_max(bst* tree, bst_key* value);
+bstnode* avl_peek_min(bst* tree);
+bstnode* avl_peek_max(bst* tree);
+bstnode* avl_search(bst* tree, bst_key value);
+void avl_enable_hash(bst* tree);
+void avl_disable_hash(bst* tree);
+void avl_enable_cache(bst* tree, size_t entries);
+void avl_disable_cache(bst* tree);
+void avl_search_many(bst* tree, const bst_key* values, size_t n, bstnode** out);
+int avl_start_trace(bst* tree, const char* path);
+void avl_stop_trace(bst* tree);
+
+bstnode* avl_lower_bound(bst* tree, bst_key value, bst_size* rank);
+bstnode* avl_upper_bound(bst* tree, bst_key value, bst_size* rank);
+bstnode* avl_predecessor(bst* tree, bst_key value, bst_size* rank);
+bstnode* avl_successor(bst* tree, bst_key value, bst_size* rank);
+bstnode* avl_nearest(bst* tree, bst_key value, bst_size* rank);
+bstnode* avl_next(bstnode* current);
+bstnode* avl_prev(bstnode* current);
+bstnode* avl_index(bst* tree, bst_size index);
+bst_size avl_get_index(bst* tree, bst_key value);
+void avl_index_batch(bst* tree, const bst_size* ranks, size_t k, bstnode** out);
+void avl_get_index_batch(bst* tree, const bst_key* values, size_t k, bst_size* out);
+
+int avl_insert_payload(bst* tree, bst_key value, bst_aggregate payload);
+bst_aggregate avl_range_aggregate(bst* tree, bst_key lo, bst_key hi, int monoid);
+
+bst* avl_create_weighted(void);
+bst_aggregate avl_total_weight(bst* tree);
+bst_aggregate avl_weighted_rank(bst* tree, bst_key value);
+bstnode* avl_select_by_weight(bst* tree, bst_aggregate weight);
+void avl_rng_seed(avl_rng* rng, uint64_t seed);
+uint64_t avl_rng_next(avl_rng* rng);
+bstnode* avl_sample_weighted(bst* tree, avl_rng* rng);
+bstnode* avl_sample(bst* tree, avl_rng* rng);
 
 void avl_rotate_left(bst* tree, bstnode* center);
 void avl_rotate_right(bst* tree, bstnode* center);
 
+void avl_memory_stats(bst* tree, avl_stats* stats, int exact);
+void avl_compact(bst* tree);
+int avl_compact_incremental(bst* tree, int budget);
+
 void avl_clear(bst* tree);
 void avl_destroy(bst* tree);
 void avl_clear_destroy(bst* tree);
 
-void _avl_delete_balancing(bst* tree, bstnode* rebalance_node, int delete_direction);
+void avl_node_delete(bst* tree, bstnode* todelete);
+void avl_node_unlink(bst* tree, bstnode* todelete);
+int avl_rebalance(bst* tree, bstnode* rebalance_node, int direction);
+int _avl_delete_balancing(bst* tree, bstnode* rebalance_node, int delete_direction);
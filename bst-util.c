@@ -17,7 +17,7 @@ void inorder_traverse(bstnode* head)
     if (head == NULL) return;
 
     inorder_traverse(head->left);
-    printf("%d ", head->value);
+    printf(BST_KEY_FMT " ", head->value);
     inorder_traverse(head->right);
 }
 
@@ -42,7 +42,7 @@ void subtree_node_counts(bstnode* head, int verbose)
     subtree_traverse(head->right, &right_nodes);
 
     if (verbose) {
-        printf("For node %d...\n", head->value);
+        printf("For node " BST_KEY_FMT "...\n", head->value);
         printf("\tleft subtree:\t%d\n", left_nodes);
         printf("\tright subtree:\t%d\n", right_nodes);
     }
@@ -60,7 +60,7 @@ int calculate_tree_height(bstnode* head)
     int right = calculate_tree_height(head->right);
 
     /*
-    printf("(calculate_height) For node %d...\n", head->value);
+    printf("(calculate_height) For node " BST_KEY_FMT "...\n", head->value);
     printf("\tLeft Height:\t%d\n", left);
     printf("\tRight Height:\t%d\n", right);
     */
@@ -80,7 +80,7 @@ void check_strict_balance(bstnode* head, int verbose)
     int right_height = calculate_tree_height(head->right);
 
     if (verbose) {
-        printf("(check balance) For node %d...\n", head->value);
+        printf("(check balance) For node " BST_KEY_FMT "...\n", head->value);
         printf("\tleft tree:\t%d\n", left_height);
         printf("\tright tree:\t%d\n", right_height);
         printf("\tbalance:\t%d\n", right_height - left_height);
@@ -104,33 +104,35 @@ void check_rank(bstnode* head, int verbose)
     int calculated_rank = 1;
     subtree_traverse(head->left, &calculated_rank);
     if (verbose) {
-        printf("For node %d\n", head->value);
-        printf("Calculated Rank: %d\nStored Rank: %d\n", calculated_rank, head->rank);
+        printf("For node " BST_KEY_FMT "\n", head->value);
+        printf("Calculated Rank: %d\nStored Rank: " BST_SIZE_FMT "\n", calculated_rank, head->rank);
     }
-    assert(calculated_rank = head->rank);
+    assert(calculated_rank == head->rank);
 
     check_rank(head->right, verbose);
 }
 
-void _inorder_tree_to_array(bstnode* head, int* index, int* array, int length)
+void _inorder_tree_to_array(bstnode* head, bst_size* index, bst_key* array, bst_size length)
 {
     if (head == NULL) return;
 
     _inorder_tree_to_array(head->left, index, array, length);
-    if (*index >= length) {
-        fprintf(stderr, "ERROR: Array index out of range in _inorder_tree_to_array\n");
-        exit(-1);
-    }
+    if (!head->dead) {
+        if (*index >= length) {
+            fprintf(stderr, "ERROR: Array index out of range in _inorder_tree_to_array\n");
+            exit(-1);
+        }
 
-    array[*index] = head->value;
-    (*index)++;
+        array[*index] = head->value;
+        (*index)++;
+    }
     _inorder_tree_to_array(head->right, index, array, length);
 }
 
 
-int isordered(int* array, int n) 
+int isordered(bst_key* array, bst_size n) 
 {
-    for (int i=1; i<n; i++) {
+    for (bst_size i=1; i<n; i++) {
         if (array[i] < array[i-1]) {
             return 0;
         }
@@ -146,13 +148,13 @@ void check_bst_ordering(bst* tree)
         return;
     }
 
-    int* elements = malloc(sizeof(int) * tree->length);
+    bst_key* elements = malloc(sizeof(bst_key) * tree->length);
     if (!elements) {
         fprintf(stderr, "Mallocation error in check_bst_ordering.\n");
         exit(-1);
     }
         
-    int index = 0;
+    bst_size index = 0;
     _inorder_tree_to_array(tree->head, &index, elements, tree->length);
 
     assert(isordered(elements, tree->length));
@@ -166,24 +168,79 @@ void check_bst_indexing(bst* tree)
         return;
     }
 
-    int* elements = malloc(sizeof(int) * tree->length);
+    bst_key* elements = malloc(sizeof(bst_key) * tree->length);
     if (!elements) {
         fprintf(stderr, "Mallocation error in check_bst_ordering.\n");
         exit(-1);
     }
         
-    int index = 0;
+    bst_size index = 0;
     _inorder_tree_to_array(tree->head, &index, elements, tree->length);
 
-    int* indexed_elements = malloc(sizeof(int) * tree->length);
-    for (int i=1;i<=tree->length;i++) {
+    bst_key* indexed_elements = malloc(sizeof(bst_key) * tree->length);
+    for (bst_size i=1;i<=tree->length;i++) {
         indexed_elements[i-1] = bst_index(tree, i)->value;
     }
 
-    for (int i=0; i<tree->length;i++){
+    for (bst_size i=0; i<tree->length;i++){
        assert(indexed_elements[i] == elements[i]);
     }
 
     free(elements);
     free(indexed_elements);
 }
+
+
+void check_parent_links(bstnode* head)
+{
+    if (head == NULL) return;
+
+    if (head->left) {
+        assert(head->left->parent == head);
+        check_parent_links(head->left);
+    }
+
+    if (head->right) {
+        assert(head->right->parent == head);
+        check_parent_links(head->right);
+    }
+}
+
+
+void check_extremes(bst* tree)
+{
+    // the cached leftmost and rightmost nodes must match the real ones
+    assert(tree->leftmost == bst_node_min(tree->head));
+    assert(tree->rightmost == bst_node_max(tree->head));
+}
+
+
+bst_size check_subtree_ranks(bstnode* head)
+{
+    // returns the number of live nodes in the subtree, and verifies that
+    // the rank of each node is the number of live nodes in its left
+    // subtree, plus one if it is live itself, along the way.
+    if (head == NULL) return 0;
+
+    bst_size left = check_subtree_ranks(head->left);
+    bst_size right = check_subtree_ranks(head->right);
+
+    assert(head->rank == left + !head->dead);
+
+    return left + right + !head->dead;
+}
+
+
+int check_balance_factors(bstnode* head)
+{
+    // returns the height of the subtree, and verifies that the stored
+    // AVL balance factors match the actual subtree heights.
+    if (head == NULL) return 0;
+
+    int left = check_balance_factors(head->left);
+    int right = check_balance_factors(head->right);
+
+    assert(head->balance_factor == right - left);
+
+    return 1 + MAX(left, right);
+}
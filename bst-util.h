@@ -21,3 +21,7 @@ void subtree_node_counts(bstnode* head, int verbose);
 void check_strict_balance(bstnode* head, int verbose);
 void check_bst_ordering(bst* tree);
 void check_bst_indexing(bst* tree);
+void check_parent_links(bstnode* head);
+void check_extremes(bst* tree);
+bst_size check_subtree_ranks(bstnode* head);
+int check_balance_factors(bstnode* head);
@@ -14,6 +14,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include "bst.h"
+#include "augment.h"
+#include "hash.h"
+#include "cache.h"
+#include "trace.h"
+#include "arena.h"
 
 void _traverse_and_count(bstnode* head, int* cnt)
 {
@@ -40,10 +45,8 @@ void bst_rotate(bst* tree, bstnode* center, int direction)
 
     bstnode* pivot = BRANCH(REVERSE_DIRECTION(direction), center);
 
-    // named subtrees, for convenience
-    bstnode* alpha = BRANCH(direction, center);
+    // the subtree of pivot that moves across to center
     bstnode* beta = BRANCH(direction, pivot);
-    bstnode* gamma = BRANCH(REVERSE_DIRECTION(direction), pivot);
 
     // Check if the center of rotation is the root of the
     // tree. If so, we'll need to make the pivot the new
@@ -79,11 +82,19 @@ void bst_rotate(bst* tree, bstnode* center, int direction)
         beta->parent = center;
     }
 
-    // kinda a crappy way of doing this...
-    if (pivot->parent && pivot->parent->left && pivot->parent->left->value == center->value)
+    // the parent's slot is found by identity rather than by key, so that
+    // trees whose values aren't keys (see seq.h) can be rotated too
+    if (pivot->parent && pivot->parent->left == center)
         pivot->parent->left = pivot;
-    else if (pivot->parent && pivot->parent->right && pivot->parent->right->value == center->value)
+    else if (pivot->parent)
         pivot->parent->right = pivot;
+
+    // center is now the child of pivot, so its aggregates must be
+    // brought up to date first.
+    if (tree->augment) {
+        bst_update_aggregates(tree, center);
+        bst_update_aggregates(tree, pivot);
+    }
 }
 
 
@@ -99,45 +110,188 @@ void bst_rotate_right(bst* tree, bstnode* center)
 }
 
 
-int bst_node_delete(bst* tree, bstnode* del_node, node** path_tracker)
+void _bst_replace_child(bst* tree, bstnode* parent, bstnode* old_child, bstnode* new_child)
 {
-    // if there's only one element in the tree, we'll just handle that
-    // as a special case.
-    if (tree->length == 1) {
-        tree->head = NULL;
-        tree->length--;
-        free(del_node);
-        return 1;
-    }
+    if (!parent)
+        tree->head = new_child;
+    else if (parent->left == old_child)
+        parent->left = new_child;
+    else
+        parent->right = new_child;
+
+    if (new_child)
+        new_child->parent = parent;
+}
+
+
+bstnode* bst_node_min(bstnode* head)
+{
+    if (!head) return NULL;
+
+    while (head->left)
+        head = head->left;
+
+    return head;
+}
+
+
+bstnode* bst_node_max(bstnode* head)
+{
+    if (!head) return NULL;
+
+    while (head->right)
+        head = head->right;
+
+    return head;
+}
+
+
+bstnode* bst_node_next(bstnode* current)
+{
+    // the in-order successor of current. Stepping through the whole tree
+    // this way crosses each edge twice, so it's amortized O(1) per step.
+    if (current->right)
+        return bst_node_min(current->right);
+
+    while (current->parent && current->parent->right == current)
+        current = current->parent;
+
+    return current->parent;
+}
+
+
+bstnode* bst_node_prev(bstnode* current)
+{
+    if (current->left)
+        return bst_node_max(current->left);
+
+    while (current->parent && current->parent->left == current)
+        current = current->parent;
+
+    return current->parent;
+}
+
+
+bst_size bst_node_index(bstnode* node)
+{
+    // The index of a live node, found by walking up to the root rather than
+    // searching down from it. Every ancestor that node is to the right of
+    // comes before it, along with its left subtree.
+    bst_size index = node->rank;
+    for (bstnode* parent = node->parent; parent; node = parent, parent = parent->parent)
+        index += (parent->right == node) ? parent->rank : 0;
+
+    return index;
+}
+
 
-    // we want to move the node to be deleted down the tree
-    // until it has no right children
-    while(del_node->right) {
-        track_update(path_tracker, del_node->right, RIGHT);
-        bst_rotate_left(tree, del_node);
+bstnode* bst_node_next_live(bstnode* current)
+{
+    // like bst_node_next, but skipping over dead nodes, which also works
+    // as a way of finding the first live node from a dead one.
+    do {
+        current = bst_node_next(current);
+    } while (current && current->dead);
+
+    return current;
+}
+
+
+bstnode* bst_node_prev_live(bstnode* current)
+{
+    do {
+        current = bst_node_prev(current);
+    } while (current && current->dead);
+
+    return current;
+}
+
+
+bstnode* bst_node_unlink(bst* tree, bstnode* del_node, int* fix_direction)
+{
+    // Removes del_node from the tree without freeing it, keeping ranks and
+    // parent pointers consistent. Returns the parent of the position that
+    // physically lost a node, with the side it was lost from stored in
+    // fix_direction, so that balanced trees know where to start fixing things.
+    // The node that physically leaves its position in the tree. If del_node
+    // has two children, this is its in-order successor, which will be moved
+    // into del_node's place once it has been snipped out.
+    bstnode* removed = (del_node->left && del_node->right) ? 
+        bst_node_min(del_node->right) : del_node;
+
+    if (tree->hash)
+        bst_hash_remove(tree->hash, del_node->value);
+    if (tree->cache) {
+        bst_cache_remove(tree->cache, del_node->value);
+
+        // dead nodes don't count towards anything's rank
+        if (!del_node->dead)
+            bst_cache_ranks_changed(tree->cache);
     }
 
-    // once it has no right children, we can "snip" it out
-    // of the tree.
-    if (del_node->left) {
-        del_node->left->parent = del_node->parent;
+    // the extremes never have two children, so their neighbours are still
+    // in the tree once they're gone.
+    if (del_node == tree->leftmost)
+        tree->leftmost = bst_node_next(del_node);
+    if (del_node == tree->rightmost)
+        tree->rightmost = bst_node_prev(del_node);
+
+    bstnode* child = (removed->left) ? removed->left : removed->right;
+    bstnode* fix_parent = removed->parent;
+    int direction = (fix_parent && fix_parent->left == removed) ? LEFT : RIGHT;
+
+    _bst_replace_child(tree, fix_parent, removed, child);
+
+    if (removed != del_node) {
+        // The successor takes over del_node's position, along with its rank
+        // (del_node's left subtree is unchanged) and its balancing information.
+        if (fix_parent == del_node)
+            fix_parent = removed;
+
+        removed->left = del_node->left;
+        removed->right = del_node->right;
+        removed->rank = del_node->rank - !del_node->dead + !removed->dead;
+        removed->balance_factor = del_node->balance_factor;
+
+        if (removed->left) removed->left->parent = removed;
+        if (removed->right) removed->right->parent = removed;
+
+        _bst_replace_child(tree, del_node->parent, del_node, removed);
     }
 
-    if (del_node->value < del_node->parent->value) {
-        del_node->parent->left = del_node->left;
-        del_node->parent->rank = del_node->rank;
-    } else {
-        del_node->parent->right = del_node->left;
+    // Every ancestor of the removed position that reached it through its
+    // left subtree has lost one node from that subtree, if it was a live
+    // one. Above del_node's position, it's del_node that has gone.
+    bstnode* current = fix_parent;
+    int step = direction;
+    int lost = !removed->dead;
+    while (current) {
+        if (step == LEFT)
+            current->rank -= lost;
+
+        if (tree->augment)
+            bst_update_aggregates(tree, current);
+
+        if (current == removed)
+            lost = !del_node->dead;
+
+        if (current->parent)
+            step = (current->parent->left == current) ? LEFT : RIGHT;
+        current = current->parent;
     }
 
-    free(del_node);
-    tree->length--;
+    del_node->left = del_node->right = del_node->parent = NULL;
+    if (del_node->dead)
+        tree->dead--;
+    else
+        tree->length--;
 
-    return 1;
+    *fix_direction = direction;
+    return fix_parent;
 }
 
 
-bstnode* bstnode_create(int value)
+bstnode* bstnode_create(bst_key value)
 {
     bstnode* newnode = malloc(sizeof(bstnode));
     if (!newnode){
@@ -154,29 +308,66 @@ bstnode* bstnode_create(int value)
 }
 
 
-int bst_get_index(bst* tree, int value) 
+bstnode* bst_create_node(bst* tree, bst_key value)
 {
+    if (!tree->augment) {
+        return bstnode_create(value);
+    }
+
+    size_t size = bst_node_size(tree);
+    bstnode* newnode = malloc(size);
+    if (!newnode){
+        fprintf(stderr, "MEMORY ERROR in bst_create_node. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    memset(newnode, 0, size);
+
+    newnode->value = value;
+    newnode->rank = 1;
+    bst_update_aggregates(tree, newnode);
+
+    return newnode;
+}
+
+
+bst_size bst_get_index(bst* tree, bst_key value) 
+{
+    bst_size index;
+    bst_search_index(tree, value, &index);
+    return index;
+}
+
+
+bstnode* bst_search_index(bst* tree, bst_key value, bst_size* index)
+{
+    // Finds the live node holding value, and its index, in one descent. If
+    // there isn't one, returns NULL with the index set to -1.
     bstnode* current = tree->head;
-    int index = 0;
+    *index = 0;
 
     while (current)  {
         if (current->value == value) {
-            return index + current->rank;
+            if (current->dead) break;
+
+            *index += current->rank;
+            return current;
         }
         if (value < current->value){
             current = current->left;
         }
         else if (value > current->value) {
-            index += current->rank;
+            *index += current->rank;
             current = current->right;
         }        
     }
 
-    return -1;
+    *index = -1;
+    return NULL;
 }
 
 
-bstnode* bst_find_node_and_path(bst* tree, int value, node** path_tracker,
+bstnode* bst_find_node_and_path(bst* tree, bst_key value, node** path_tracker,
         int rank_update)
 {
     bstnode* current = tree->head;
@@ -204,18 +395,19 @@ bstnode* bst_find_node_and_path(bst* tree, int value, node** path_tracker,
 }
 
 
-int bst_delete(bst* tree, int value)
+int bst_delete(bst* tree, bst_key value)
 {
-    node* path_tracker = init_update_tracker();
-    bstnode* todelete = bst_find_node_and_path(tree, value, &path_tracker, -1);
+    // bst_node_unlink keeps the ranks exact, and copes with deleting a root
+    // that has no right child.
+    bstnode* todelete = bst_search(tree, value);
 
     if (!todelete) {
-        revert_rank_updates(path_tracker, +1);
         return 0;
     }
 
-    bst_node_delete(tree, todelete, &path_tracker);
-    destroy_update_tracker(path_tracker);
+    int direction;
+    bst_node_unlink(tree, todelete, &direction);
+    bst_free_node(tree, todelete);
 
     return 1;
 }
@@ -223,6 +415,18 @@ int bst_delete(bst* tree, int value)
 
 void bst_node_insert(bst* tree, bstnode* newnode, node* path_tracker)
 {
+    // a NULL path_tracker means the tree is empty, and newnode is the root
+    if (tree->hash)
+        bst_hash_put(tree->hash, newnode);
+    if (tree->cache)
+        bst_cache_ranks_changed(tree->cache);
+
+    if (!path_tracker) {
+        tree->head = tree->leftmost = tree->rightmost = newnode;
+        tree->length++;
+        return;
+    }
+
     bstnode* insert_location = path_tracker->treenode;
     if (path_tracker->direction == LEFT)
         insert_location->left = newnode;
@@ -231,19 +435,25 @@ void bst_node_insert(bst* tree, bstnode* newnode, node* path_tracker)
 
    newnode->parent = insert_location;
    tree->length++;
+
+   if (newnode->value < tree->leftmost->value)
+       tree->leftmost = newnode;
+   else if (newnode->value > tree->rightmost->value)
+       tree->rightmost = newnode;
+
+   bst_update_path_aggregates(tree, newnode);
 }
 
 
 
-int bst_insert(bst* tree, int value)
+int bst_insert(bst* tree, bst_key value)
 {
-    bstnode* newnode = bstnode_create(value);
+    bstnode* newnode = bst_create_node(tree, value);
 
     // if the tree doesn't have a root node
     // then just add this one as root and end.
-    if (tree->length == 0) {
-        tree->head = newnode;
-        tree->length++;
+    if (!tree->head) {
+        bst_node_insert(tree, newnode, NULL);
         return 1;
     }
 
@@ -265,15 +475,28 @@ int bst_insert(bst* tree, int value)
 }
 
 
-bstnode* bst_index(bst* tree, int index)
+bstnode* bst_peek_min(bst* tree)
+{
+    return tree->leftmost;
+}
+
+
+bstnode* bst_peek_max(bst* tree)
+{
+    return tree->rightmost;
+}
+
+
+bstnode* bst_index(bst* tree, bst_size index)
 {
-    int old_index = index;
     if (index > tree->length || index <= 0) return NULL;    
     bstnode* current = tree->head;
     while (current) {
-        if (index == current->rank) return current;
+        // a dead node's rank doesn't count itself, so an index equal to it
+        // lies in the left subtree.
+        if (index == current->rank && !current->dead) return current;
 
-        if (index < current->rank) current = current->left;
+        if (index <= current->rank) current = current->left;
         else {
             index = index - current->rank;
             current = current->right;
@@ -284,12 +507,319 @@ bstnode* bst_index(bst* tree, int index)
 }
 
 
-bstnode* bst_search(bst* tree, int value)
+typedef struct BatchQuery {
+    bst_key key;
+    size_t position;
+} batch_query;
+
+
+static int _compare_batch_queries(const void* a, const void* b)
 {
+    bst_key x = ((const batch_query*) a)->key;
+    bst_key y = ((const batch_query*) b)->key;
+
+    return (x > y) - (x < y);
+}
+
+
+static batch_query* _sort_batch_queries(const bst_key* keys, size_t k)
+{
+    batch_query* queries = malloc(sizeof(batch_query) * k);
+    if (!queries) {
+        fprintf(stderr, "MEMORY ERROR in _sort_batch_queries. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    for (size_t i=0; i<k; i++) {
+        queries[i].key = keys[i];
+        queries[i].position = i;
+    }
+
+    qsort(queries, k, sizeof(batch_query), _compare_batch_queries);
+    return queries;
+}
+
+
+static size_t _first_query_at_least(batch_query* queries, size_t lo, size_t hi, bst_key key)
+{
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (queries[mid].key < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+
+static size_t _first_query_above(batch_query* queries, size_t lo, size_t hi, bst_key key)
+{
+    // an upper bound, rather than a search for key + 1, which would overflow
+    // when key is the largest bst_key
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (queries[mid].key <= key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+
+static int _batch_should_scan(bst* tree, size_t k)
+{
+    // Once there are enough queries that the descents would touch most
+    // of the tree anyway, a single in-order pass is cheaper.
+    int height = 1;
+    for (bst_size n = tree->length; n > 1; n >>= 1)
+        height++;
+
+    return k * height > (size_t) tree->length;
+}
+
+
+static void _index_batch(bstnode* head, bst_size offset, batch_query* queries,
+        size_t lo, size_t hi, bstnode** out)
+{
+    if (lo >= hi) return;
+
+    if (!head) {
+        for (size_t i=lo; i<hi; i++)
+            out[queries[i].position] = NULL;
+        return;
+    }
+
+    // split the queries around this node, and send each part down the
+    // appropriate side.
+    bst_size index = offset + head->rank;
+    size_t split_lo = _first_query_at_least(queries, lo, hi, index + head->dead);
+    size_t split_hi = _first_query_at_least(queries, split_lo, hi, index + 1);
+
+    _index_batch(head->left, offset, queries, lo, split_lo, out);
+
+    for (size_t i=split_lo; i<split_hi; i++)
+        out[queries[i].position] = head;
+
+    _index_batch(head->right, index, queries, split_hi, hi, out);
+}
+
+
+void bst_index_batch(bst* tree, const bst_size* indexes, size_t k, bstnode** out)
+{
+    if (k == 0) return;
+
+    batch_query* queries = _sort_batch_queries(indexes, k);
+
+    if (_batch_should_scan(tree, k)) {
+        bstnode* current = bst_node_min(tree->head);
+        if (current && current->dead)
+            current = bst_node_next_live(current);
+
+        bst_size index = 1;
+        for (size_t i=0; i<k; i++) {
+            while (current && index < queries[i].key) {
+                current = bst_node_next_live(current);
+                index++;
+            }
+
+            out[queries[i].position] = (queries[i].key >= 1) ? current : NULL;
+        }
+    } else {
+        _index_batch(tree->head, 0, queries, 0, k, out);
+    }
+
+    free(queries);
+}
+
+
+static void _get_index_batch(bstnode* head, bst_size offset, batch_query* queries,
+        size_t lo, size_t hi, bst_size* out)
+{
+    if (lo >= hi) return;
+
+    if (!head) {
+        for (size_t i=lo; i<hi; i++)
+            out[queries[i].position] = -1;
+        return;
+    }
+
+    size_t split_lo = _first_query_at_least(queries, lo, hi, head->value);
+    size_t split_hi = (split_lo < hi && queries[split_lo].key == head->value) ?
+        _first_query_above(queries, split_lo, hi, head->value) : split_lo;
+
+    _get_index_batch(head->left, offset, queries, lo, split_lo, out);
+
+    for (size_t i=split_lo; i<split_hi; i++)
+        out[queries[i].position] = (head->dead) ? -1 : offset + head->rank;
+
+    _get_index_batch(head->right, offset + head->rank, queries, split_hi, hi, out);
+}
+
+
+void bst_get_index_batch(bst* tree, const bst_key* values, size_t k, bst_size* out)
+{
+    if (k == 0) return;
+
+    batch_query* queries = _sort_batch_queries(values, k);
+
+    if (_batch_should_scan(tree, k)) {
+        bstnode* current = bst_node_min(tree->head);
+        if (current && current->dead)
+            current = bst_node_next_live(current);
+
+        bst_size index = 1;
+        for (size_t i=0; i<k; i++) {
+            while (current && current->value < queries[i].key) {
+                current = bst_node_next_live(current);
+                index++;
+            }
+
+            out[queries[i].position] = (current && current->value == queries[i].key) ?
+                index : -1;
+        }
+    } else {
+        _get_index_batch(tree->head, 0, queries, 0, k, out);
+    }
+
+    free(queries);
+}
+
+
+static bstnode* _bst_first_after(bst* tree, bst_key value, int inclusive, bst_size* rank)
+{
+    // the smallest node greater than (or equal to, if inclusive) value.
+    // rank is set to the index that node has, or length + 1 if there isn't
+    // one, which is one more than the number of nodes before value either way.
     bstnode* current = tree->head;
+    bstnode* found = NULL;
+    bst_size index = 0;
+
     while (current) {
-        if (current->value == value)
+        if (current->value > value || (inclusive && current->value == value)) {
+            found = current;
+            current = current->left;
+        } else {
+            index += current->rank;
+            current = current->right;
+        }
+    }
+
+    // the descent ignores liveness, so step past any dead nodes
+    if (found && found->dead)
+        found = bst_node_next_live(found);
+
+    if (rank) *rank = index + 1;
+    return found;
+}
+
+
+static bstnode* _bst_last_before(bst* tree, bst_key value, int inclusive, bst_size* rank)
+{
+    // the largest node less than (or equal to, if inclusive) value. rank
+    // is set to its index, or 0 if there isn't one.
+    bstnode* current = tree->head;
+    bstnode* found = NULL;
+    bst_size index = 0;
+
+    while (current) {
+        if (current->value < value || (inclusive && current->value == value)) {
+            found = current;
+            index += current->rank;
+            current = current->right;
+        } else {
+            current = current->left;
+        }
+    }
+
+    if (found && found->dead)
+        found = bst_node_prev_live(found);
+
+    if (rank) *rank = index;
+    return found;
+}
+
+
+bstnode* bst_lower_bound(bst* tree, bst_key value, bst_size* rank)
+{
+    return _bst_first_after(tree, value, 1, rank);
+}
+
+
+bstnode* bst_upper_bound(bst* tree, bst_key value, bst_size* rank)
+{
+    return _bst_first_after(tree, value, 0, rank);
+}
+
+
+bstnode* bst_predecessor(bst* tree, bst_key value, bst_size* rank)
+{
+    return _bst_last_before(tree, value, 0, rank);
+}
+
+
+bstnode* bst_successor(bst* tree, bst_key value, bst_size* rank)
+{
+    return _bst_first_after(tree, value, 0, rank);
+}
+
+
+bstnode* bst_nearest(bst* tree, bst_key value, bst_size* rank)
+{
+    // track the closest node on either side of value in a single descent,
+    // and return whichever is closer (the smaller one, on a tie).
+    bstnode* current = tree->head;
+    bstnode* below = NULL;
+    bstnode* above = NULL;
+    bst_size index = 0;
+
+    while (current) {
+        if (current->value == value && !current->dead) {
+            if (rank) *rank = index + current->rank;
             return current;
+        }
+
+        if (current->value < value) {
+            below = current;
+            index += current->rank;
+            current = current->right;
+        } else {
+            above = current;
+            current = current->left;
+        }
+    }
+
+    // index is now the number of nodes before value, and the candidates
+    // are the closest nodes on either side, once past any dead ones.
+    if (below && below->dead)
+        below = bst_node_prev_live(below);
+    if (above && above->dead)
+        above = bst_node_next_live(above);
+
+    if (below && (!above || (uint64_t) value - below->value <= (uint64_t) above->value - value)) {
+        if (rank) *rank = index;
+        return below;
+    }
+
+    if (rank) *rank = (above) ? index + 1 : 0;
+    return above;
+}
+
+
+bstnode* bst_search(bst* tree, bst_key value)
+{
+    if (tree->hash) {
+        bstnode* found = bst_hash_get(tree->hash, value);
+        return (found && !found->dead) ? found : NULL;
+    }
+
+    bstnode* current = tree->head;
+    while (current) {
+        if (current->value == value)
+            return (current->dead) ? NULL : current;
 
         current = current->value > value ? current->left : current->right;
     }
@@ -298,6 +828,100 @@ bstnode* bst_search(bst* tree, int value)
 }
 
 
+void bst_search_many(bst* tree, const bst_key* values, size_t n, bstnode** out, int group)
+{
+    // Independent searches are each bound by the latency of a chain of
+    // dependent cache misses. Running a group of them in lock-step, and
+    // prefetching the next node of each search before moving on to the
+    // others, lets those misses overlap.
+    bstnode* current[BST_MAX_SEARCH_GROUP];
+    size_t query[BST_MAX_SEARCH_GROUP];
+
+    if (group > BST_MAX_SEARCH_GROUP) group = BST_MAX_SEARCH_GROUP;
+    if (group < 1) group = 1;
+
+    size_t next = 0;
+    int active = 0;
+    while (active < group && next < n) {
+        query[active] = next++;
+        current[active++] = tree->head;
+    }
+
+    while (active) {
+        for (int i=0; i<active; ) {
+            bstnode* node = current[i];
+            bst_key value = values[query[i]];
+
+            if (!node || node->value == value) {
+                // this search is finished, so start a new one in its slot,
+                // or retire the slot if there are none left.
+                out[query[i]] = (node && node->dead) ? NULL : node;
+
+                if (next < n) {
+                    query[i] = next++;
+                    current[i++] = tree->head;
+                } else {
+                    active--;
+                    query[i] = query[active];
+                    current[i] = current[active];
+                }
+
+                continue;
+            }
+
+            node = (node->value > value) ? node->left : node->right;
+            __builtin_prefetch(node);
+            current[i++] = node;
+        }
+    }
+}
+
+
+void bst_free_node(bst* tree, bstnode* node)
+{
+    // Frees a node that is no longer linked into the tree. Nodes relocated
+    // by avl_compact live in one of the tree's arenas, and only count
+    // against it; an arena that is full and has no live nodes left is
+    // released.
+    bst_arena** link = &tree->arenas;
+    while (*link && !bst_arena_contains(*link, node))
+        link = &(*link)->next;
+
+    if (!*link) {
+        free(node);
+        return;
+    }
+
+    bst_arena* arena = *link;
+    if (--arena->live == 0 && arena->used == arena->capacity) {
+        *link = arena->next;
+        bst_arena_destroy(arena);
+    }
+}
+
+
+bstnode* bst_node_relocate(bst* tree, bstnode* node, bstnode* dest)
+{
+    // Moves node (with its augmentation) to dest, fixing every pointer to
+    // it, and frees the original. Nothing about the tree's structure
+    // changes, but any pointers to node held outside of it are left
+    // dangling.
+    memcpy(dest, node, bst_node_size(tree));
+
+    _bst_replace_child(tree, node->parent, node, dest);
+    if (dest->left) dest->left->parent = dest;
+    if (dest->right) dest->right->parent = dest;
+
+    if (tree->leftmost == node) tree->leftmost = dest;
+    if (tree->rightmost == node) tree->rightmost = dest;
+    if (tree->hash) bst_hash_put(tree->hash, dest);
+    if (tree->cache) bst_cache_move(tree->cache, node, dest);
+
+    bst_free_node(tree, node);
+    return dest;
+}
+
+
 bst* bst_create()
 {
     bst* tree = malloc(sizeof(bst));
@@ -312,9 +936,42 @@ bst* bst_create()
 }
 
 
+static void _traverse_and_free_malloced(bst* tree, bstnode* head)
+{
+    // frees the nodes that aren't in one of the tree's arenas
+    if (head == NULL) return;
+    _traverse_and_free_malloced(tree, head->left);
+    _traverse_and_free_malloced(tree, head->right);
+
+    bst_arena* arena = tree->arenas;
+    while (arena && !bst_arena_contains(arena, head))
+        arena = arena->next;
+
+    if (!arena)
+        free(head);
+}
+
+
 void bst_clear(bst* tree)
 {
-    _traverse_and_free(tree->head);
+    if (tree->arenas) {
+        _traverse_and_free_malloced(tree, tree->head);
+
+        while (tree->arenas) {
+            bst_arena* next = tree->arenas->next;
+            bst_arena_destroy(tree->arenas);
+            tree->arenas = next;
+        }
+
+        tree->relocating = 0;
+    } else {
+        _traverse_and_free(tree->head);
+    }
+
+    if (tree->hash)
+        bst_hash_clear(tree->hash);
+    if (tree->cache)
+        bst_cache_clear(tree->cache);
 }
 
 
@@ -329,6 +986,10 @@ void _traverse_and_free(bstnode* head)
 
 void bst_destroy(bst* tree)
 {
+    free(tree->augment);
+    bst_hash_destroy(tree->hash);
+    bst_cache_destroy(tree->cache);
+    bst_trace_close(tree->trace);
     free(tree);
 }
 
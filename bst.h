@@ -13,6 +13,7 @@
 #pragma once
 
 #include <assert.h>
+#include <stddef.h>
 #include "nodes.h"
 #include "tracker.h"
 
@@ -31,20 +32,73 @@
 
 #define ASSERT_NOT_REACHED() (assert(0))
 
+// the largest number of searches bst_search_many will keep in flight
+#define BST_MAX_SEARCH_GROUP 64
+
 typedef struct BST {
-    int length;
+    bst_size length;
     bstnode* head;
+
+    // NULL unless the tree was created with an augmentation
+    struct BSTAugment* augment;
+
+    // NULL unless an exact-match index has been enabled (see hash.h)
+    struct BSTHash* hash;
+
+    // NULL unless a front cache of hot keys has been enabled (see cache.h)
+    struct BSTCache* cache;
+
+    // NULL unless the avl_ functions are recording a trace (see trace.h)
+    struct BSTTrace* trace;
+
+    // regions holding the nodes relocated by avl_compact, newest first (see
+    // arena.h), and the progress of an incremental relocation pass, which
+    // moves nodes into the newest one in key order. The cursor is the key of
+    // the next node to move.
+    struct BSTArena* arenas;
+    int relocating;
+    bst_key relocate_cursor;
+
+    // only maintained by the avl_ functions
+    int height;
+
+    // the smallest and largest nodes in the tree (NULL when it is empty),
+    // kept up to date by bst_node_insert and bst_node_unlink
+    bstnode* leftmost;
+    bstnode* rightmost;
+
+    // lazy deletion (see avl_set_lazy_delete). length only counts the live
+    // nodes, and dead the ones still waiting to be compacted away.
+    bst_size dead;
+    double dead_threshold;
+    int compact_step;
+    int compacting;
+    bst_key compact_cursor;
 } bst;
 
 bst* bst_create();
-bstnode* bstnode_create(int value);
+bstnode* bstnode_create(bst_key value);
+bstnode* bst_create_node(bst* tree, bst_key value);
+void bst_free_node(bst* tree, bstnode* node);
+bstnode* bst_node_relocate(bst* tree, bstnode* node, bstnode* dest);
 
-int bst_insert(bst* tree, int value);
-int bst_delete(bst* tree, int value);
-bstnode* bst_search(bst* tree, int value);
-bstnode* bst_index(bst* tree, int index);
-bstnode* bst_find_node_and_path(bst* tree, int value, node** path_tracker, int rank_update);
-int bst_get_index(bst* tree, int value);
+int bst_insert(bst* tree, bst_key value);
+int bst_delete(bst* tree, bst_key value);
+bstnode* bst_search(bst* tree, bst_key value);
+bstnode* bst_lower_bound(bst* tree, bst_key value, bst_size* rank);
+bstnode* bst_upper_bound(bst* tree, bst_key value, bst_size* rank);
+bstnode* bst_predecessor(bst* tree, bst_key value, bst_size* rank);
+bstnode* bst_successor(bst* tree, bst_key value, bst_size* rank);
+bstnode* bst_nearest(bst* tree, bst_key value, bst_size* rank);
+void bst_search_many(bst* tree, const bst_key* values, size_t n, bstnode** out, int group);
+bstnode* bst_index(bst* tree, bst_size index);
+bstnode* bst_peek_min(bst* tree);
+bstnode* bst_peek_max(bst* tree);
+bstnode* bst_find_node_and_path(bst* tree, bst_key value, node** path_tracker, int rank_update);
+bst_size bst_get_index(bst* tree, bst_key value);
+bstnode* bst_search_index(bst* tree, bst_key value, bst_size* index);
+void bst_index_batch(bst* tree, const bst_size* indexes, size_t k, bstnode** out);
+void bst_get_index_batch(bst* tree, const bst_key* values, size_t k, bst_size* out);
 
 void bst_rotate(bst* tree, bstnode* center, int direction);
 void bst_rotate_left(bst* tree, bstnode* center);
@@ -55,7 +109,15 @@ void bst_destroy(bst* tree);
 void bst_clear_destroy(bst* tree);
 
 void _traverse_and_free(bstnode* head);
-int bst_node_delete(bst* tree, bstnode* del_node, node** path_tracker);
 void bst_node_insert(bst* tree, bstnode* newnode, node* path_tracker);
+bstnode* bst_node_unlink(bst* tree, bstnode* del_node, int* fix_direction);
+bstnode* bst_node_min(bstnode* head);
+bstnode* bst_node_max(bstnode* head);
+bstnode* bst_node_next(bstnode* current);
+bstnode* bst_node_prev(bstnode* current);
+bstnode* bst_node_next_live(bstnode* current);
+bst_size bst_node_index(bstnode* node);
+bstnode* bst_node_prev_live(bstnode* current);
+void _bst_replace_child(bst* tree, bstnode* parent, bstnode* old_child, bstnode* new_child);
 void _traverse_and_count(bstnode* head, int* cnt);
 int _count_children(bstnode* head);
@@ -0,0 +1,226 @@
+/*
+ * cache.c
+ *
+ * A set-associative front cache from hot keys to their nodes and ranks.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "cache.h"
+
+
+static void* _bst_cache_alloc(size_t alignment, size_t size)
+{
+    void* memory = (alignment) ? aligned_alloc(alignment, size) : malloc(size);
+    if (!memory) {
+        fprintf(stderr, "MEMORY ERROR in bst_cache. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    memset(memory, 0, size);
+    return memory;
+}
+
+
+static size_t _bst_cache_set_index(bst_cache* cache, bst_key key)
+{
+    // Fibonacci hashing, as in hash.c. The set count is a power of two.
+    uint64_t h = (uint64_t) key * 0x9E3779B97F4A7C15ull;
+    return (size_t) (h >> 32 | h << 32) & (cache->set_count - 1);
+}
+
+
+static int _bst_cache_find(bst_cache_set* set, bst_key key)
+{
+    // the entries of a set are packed at its front, so the first empty way
+    // ends the search
+    for (int way = 0; way < BST_CACHE_WAYS && set->nodes[way]; way++) {
+        if (set->keys[way] == key)
+            return way;
+    }
+
+    return -1;
+}
+
+
+static void _bst_cache_promote(bst_cache_set* set, int way)
+{
+    // moves the entry in way to the front, and everything before it back one
+    bst_key key = set->keys[way];
+    bst_size rank = set->ranks[way];
+    bstnode* node = set->nodes[way];
+
+    for (; way > 0; way--) {
+        set->keys[way] = set->keys[way - 1];
+        set->ranks[way] = set->ranks[way - 1];
+        set->nodes[way] = set->nodes[way - 1];
+    }
+
+    set->keys[0] = key;
+    set->ranks[0] = rank;
+    set->nodes[0] = node;
+}
+
+
+bst_cache* bst_cache_create(size_t entries)
+{
+    // Makes a cache of at least entries entries (or a default size if
+    // entries is 0), rounded up to a power of two number of sets.
+    if (!entries)
+        entries = BST_CACHE_DEFAULT_ENTRIES;
+
+    bst_cache* cache = _bst_cache_alloc(0, sizeof(bst_cache));
+
+    cache->set_count = 1;
+    while (cache->set_count * BST_CACHE_WAYS < entries)
+        cache->set_count *= 2;
+
+    cache->sets = _bst_cache_alloc(BST_CACHE_LINE, sizeof(bst_cache_set) * cache->set_count);
+    cache->set_generations = _bst_cache_alloc(0, sizeof(uint64_t) * cache->set_count);
+
+    return cache;
+}
+
+
+void bst_cache_destroy(bst_cache* cache)
+{
+    if (!cache) return;
+
+    free(cache->sets);
+    free(cache->set_generations);
+    free(cache);
+}
+
+
+void bst_cache_clear(bst_cache* cache)
+{
+    // empties the cache, but keeps its counters
+    memset(cache->sets, 0, sizeof(bst_cache_set) * cache->set_count);
+}
+
+
+bstnode* bst_cache_get(bst_cache* cache, bst_key key)
+{
+    bst_cache_set* set = cache->sets + _bst_cache_set_index(cache, key);
+    int way = _bst_cache_find(set, key);
+
+    if (way < 0) {
+        cache->misses++;
+        return NULL;
+    }
+
+    cache->hits++;
+    _bst_cache_promote(set, way);
+    return set->nodes[0];
+}
+
+
+bst_size bst_cache_get_rank(bst_cache* cache, bst_key key, bstnode** node)
+{
+    // Returns the cached rank of key, or 0 if it isn't known in the current
+    // generation. node is set to the cached node, or NULL on a miss.
+    size_t index = _bst_cache_set_index(cache, key);
+    bst_cache_set* set = cache->sets + index;
+    int way = _bst_cache_find(set, key);
+
+    if (way < 0) {
+        cache->misses++;
+        *node = NULL;
+        return 0;
+    }
+
+    cache->hits++;
+    _bst_cache_promote(set, way);
+    *node = set->nodes[0];
+    return (cache->set_generations[index] == cache->generation) ? set->ranks[0] : 0;
+}
+
+
+void bst_cache_put(bst_cache* cache, bstnode* node, bst_size rank)
+{
+    // Caches node, with its rank if rank isn't 0. A key that is already
+    // cached moves to the front of its set, and a new one goes in at the
+    // back.
+    size_t index = _bst_cache_set_index(cache, node->value);
+    bst_cache_set* set = cache->sets + index;
+
+    if (rank && cache->set_generations[index] != cache->generation) {
+        // the set's other ranks are from an older generation
+        for (int way = 0; way < BST_CACHE_WAYS; way++)
+            set->ranks[way] = 0;
+        cache->set_generations[index] = cache->generation;
+    }
+
+    int way = _bst_cache_find(set, node->value);
+    if (way >= 0) {
+        set->nodes[way] = node;
+        if (rank) set->ranks[way] = rank;
+        _bst_cache_promote(set, way);
+        return;
+    }
+
+    // the first empty way, or else the least recently used one
+    way = 0;
+    while (way < BST_CACHE_WAYS - 1 && set->nodes[way])
+        way++;
+
+    set->keys[way] = node->value;
+    set->ranks[way] = rank;
+    set->nodes[way] = node;
+}
+
+
+void bst_cache_remove(bst_cache* cache, bst_key key)
+{
+    bst_cache_set* set = cache->sets + _bst_cache_set_index(cache, key);
+    int way = _bst_cache_find(set, key);
+    if (way < 0) return;
+
+    for (; way < BST_CACHE_WAYS - 1; way++) {
+        set->keys[way] = set->keys[way + 1];
+        set->ranks[way] = set->ranks[way + 1];
+        set->nodes[way] = set->nodes[way + 1];
+    }
+
+    set->ranks[way] = 0;
+    set->nodes[way] = NULL;
+}
+
+
+void bst_cache_move(bst_cache* cache, bstnode* node, bstnode* dest)
+{
+    // points node's entry, if it has one, at the copy of it in dest, without
+    // counting as a use
+    bst_cache_set* set = cache->sets + _bst_cache_set_index(cache, node->value);
+    int way = _bst_cache_find(set, node->value);
+
+    if (way >= 0 && set->nodes[way] == node)
+        set->nodes[way] = dest;
+}
+
+
+void bst_cache_ranks_changed(bst_cache* cache)
+{
+    // every cached rank is now out of date
+    cache->generation++;
+}
+
+
+double bst_cache_hit_rate(bst_cache* cache)
+{
+    size_t lookups = cache->hits + cache->misses;
+    return (lookups) ? (double) cache->hits / lookups : 0;
+}
+
+
+size_t bst_cache_bytes(bst_cache* cache)
+{
+    if (!cache) return 0;
+
+    return sizeof(bst_cache) + (sizeof(bst_cache_set) + sizeof(uint64_t)) * cache->set_count;
+}
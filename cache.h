@@ -0,0 +1,80 @@
+/*
+ * cache.h
+ *
+ * An optional front cache for the tree's hottest keys, mapping each to its
+ * node and, when known, its rank. When searches are heavily skewed, most of
+ * them are for a handful of keys, and a hit here costs a single cache line
+ * rather than a full descent.
+ *
+ * The cache is set-associative. Each set fills one cache line and holds as
+ * many entries as will fit (four with the default key and size types), and
+ * a key can only be in the set its hash picks. Within a set, entries are
+ * kept in order of use. A hit moves its entry to the front, but new entries
+ * go in at the back, in place of the least recently used one, so a key has
+ * to be looked up twice before it can push out a key that is being hit. A
+ * stream of one-off lookups only ever churns the last way of each set, and
+ * the hot keys settle at the front without any tuning.
+ *
+ * The cached rank is the key's index, which rotations never change; only
+ * inserts and deletes of live keys do. Rather than fixing up every cached
+ * rank on each of those, the cache keeps a generation, bumped whenever the
+ * ranks change, and the ranks in a set only count while the set's
+ * generation is current. Once they're out of date, the cached node still
+ * gives the rank by walking up to the root (see bst_node_index), which
+ * touches the same nodes as a search would but without a comparison at
+ * each of them. Cached nodes are always live: the shared delete,
+ * unlink and relocation code drops or moves their entries, just as it does
+ * for the exact-match index (see hash.h).
+ *
+ * Lookups rearrange the set they hit, so the cache isn't safe for
+ * concurrent readers, and the parallel read paths go around it.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "nodes.h"
+
+#define BST_CACHE_LINE 64
+#define BST_CACHE_WAYS ((int) (BST_CACHE_LINE / (sizeof(bst_key) + sizeof(bst_size) + sizeof(bstnode*))))
+
+// the size a cache is given when none is asked for
+#define BST_CACHE_DEFAULT_ENTRIES 1024
+
+typedef struct BSTCacheSet {
+    // an empty way has a NULL node, and an unknown rank is 0
+    _Alignas(BST_CACHE_LINE) bst_key keys[BST_CACHE_WAYS];
+    bst_size ranks[BST_CACHE_WAYS];
+    bstnode* nodes[BST_CACHE_WAYS];
+} bst_cache_set;
+
+typedef struct BSTCache {
+    bst_cache_set* sets;
+    size_t set_count;
+
+    // the generation each set's ranks were recorded in, kept apart from the
+    // sets so that node lookups don't have to touch them
+    uint64_t* set_generations;
+    uint64_t generation;
+
+    size_t hits;
+    size_t misses;
+} bst_cache;
+
+bst_cache* bst_cache_create(size_t entries);
+void bst_cache_destroy(bst_cache* cache);
+void bst_cache_clear(bst_cache* cache);
+
+bstnode* bst_cache_get(bst_cache* cache, bst_key key);
+bst_size bst_cache_get_rank(bst_cache* cache, bst_key key, bstnode** node);
+void bst_cache_put(bst_cache* cache, bstnode* node, bst_size rank);
+void bst_cache_remove(bst_cache* cache, bst_key key);
+void bst_cache_move(bst_cache* cache, bstnode* node, bstnode* dest);
+void bst_cache_ranks_changed(bst_cache* cache);
+
+double bst_cache_hit_rate(bst_cache* cache);
+size_t bst_cache_bytes(bst_cache* cache);
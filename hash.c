@@ -0,0 +1,153 @@
+/*
+ * hash.c
+ *
+ * An exact-match index from keys to tree nodes.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "hash.h"
+
+
+static bst_hash_entry* _bst_hash_alloc(size_t capacity)
+{
+    bst_hash_entry* slots = calloc(capacity, sizeof(bst_hash_entry));
+    if (!slots) {
+        fprintf(stderr, "MEMORY ERROR in bst_hash. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    return slots;
+}
+
+
+static size_t _bst_hash_slot(bst_hash* hash, bst_key key)
+{
+    // Fibonacci hashing. The capacity is a power of two, so the top bits of
+    // the product pick the slot. The product is rotated rather than shifted
+    // so that tables of more than 2^32 slots still use all of their slots.
+    uint64_t h = (uint64_t) key * 0x9E3779B97F4A7C15ull;
+    return (size_t) (h >> 32 | h << 32) & (hash->capacity - 1);
+}
+
+
+bst_hash* bst_hash_create(size_t expected)
+{
+    bst_hash* hash = malloc(sizeof(bst_hash));
+    if (!hash) {
+        fprintf(stderr, "MEMORY ERROR in bst_hash_create. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    hash->capacity = BST_HASH_MIN_CAPACITY;
+    while (hash->capacity < 2 * expected)
+        hash->capacity *= 2;
+
+    hash->slots = _bst_hash_alloc(hash->capacity);
+    hash->count = 0;
+
+    return hash;
+}
+
+
+void bst_hash_destroy(bst_hash* hash)
+{
+    if (!hash) return;
+
+    free(hash->slots);
+    free(hash);
+}
+
+
+void bst_hash_clear(bst_hash* hash)
+{
+    memset(hash->slots, 0, sizeof(bst_hash_entry) * hash->capacity);
+    hash->count = 0;
+}
+
+
+static void _bst_hash_grow(bst_hash* hash)
+{
+    bst_hash_entry* old = hash->slots;
+    size_t old_capacity = hash->capacity;
+
+    hash->capacity *= 2;
+    hash->slots = _bst_hash_alloc(hash->capacity);
+    hash->count = 0;
+
+    for (size_t i=0; i<old_capacity; i++) {
+        if (old[i].node)
+            bst_hash_put(hash, old[i].node);
+    }
+
+    free(old);
+}
+
+
+void bst_hash_put(bst_hash* hash, bstnode* node)
+{
+    if (2 * (hash->count + 1) > hash->capacity)
+        _bst_hash_grow(hash);
+
+    size_t i = _bst_hash_slot(hash, node->value);
+    while (hash->slots[i].node && hash->slots[i].key != node->value)
+        i = (i + 1) & (hash->capacity - 1);
+
+    if (!hash->slots[i].node)
+        hash->count++;
+
+    hash->slots[i].key = node->value;
+    hash->slots[i].node = node;
+}
+
+
+bstnode* bst_hash_get(bst_hash* hash, bst_key key)
+{
+    size_t i = _bst_hash_slot(hash, key);
+    while (hash->slots[i].node) {
+        if (hash->slots[i].key == key)
+            return hash->slots[i].node;
+
+        i = (i + 1) & (hash->capacity - 1);
+    }
+
+    return NULL;
+}
+
+
+void bst_hash_remove(bst_hash* hash, bst_key key)
+{
+    size_t mask = hash->capacity - 1;
+    size_t i = _bst_hash_slot(hash, key);
+    while (hash->slots[i].node && hash->slots[i].key != key)
+        i = (i + 1) & mask;
+
+    if (!hash->slots[i].node) return;
+
+    // Shift later entries of the probe sequence back into the hole, unless
+    // their home slot lies cyclically after the hole (in which case moving
+    // them would put them before where a lookup starts).
+    size_t hole = i;
+    for (size_t j = (i + 1) & mask; hash->slots[j].node; j = (j + 1) & mask) {
+        size_t home = _bst_hash_slot(hash, hash->slots[j].key);
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            hash->slots[hole] = hash->slots[j];
+            hole = j;
+        }
+    }
+
+    hash->slots[hole].node = NULL;
+    hash->count--;
+}
+
+
+size_t bst_hash_bytes(bst_hash* hash)
+{
+    return (hash) ? sizeof(bst_hash) + sizeof(bst_hash_entry) * hash->capacity : 0;
+}
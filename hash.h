@@ -0,0 +1,45 @@
+/*
+ * hash.h
+ *
+ * An optional exact-match index from keys to the nodes holding them, kept
+ * alongside a tree so that searches cost one probe sequence into a flat table
+ * rather than a chain of dependent cache misses down the tree. Ordered and
+ * rank queries still use the tree.
+ *
+ * The table uses open addressing with linear probing, and backward-shift
+ * deletion so there are no tombstones. Keys are stored next to the node
+ * pointers, so a miss never touches a node. It is kept up to date by the
+ * shared insert, unlink and delete code, so any balancing scheme can use it.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include <stddef.h>
+#include "nodes.h"
+
+// the table is grown once it is more than half full
+#define BST_HASH_MIN_CAPACITY 16
+
+typedef struct BSTHashEntry {
+    bst_key key;
+    bstnode* node;
+} bst_hash_entry;
+
+typedef struct BSTHash {
+    bst_hash_entry* slots;
+    size_t capacity;
+    size_t count;
+} bst_hash;
+
+bst_hash* bst_hash_create(size_t expected);
+void bst_hash_destroy(bst_hash* hash);
+void bst_hash_clear(bst_hash* hash);
+
+void bst_hash_put(bst_hash* hash, bstnode* node);
+bstnode* bst_hash_get(bst_hash* hash, bst_key key);
+void bst_hash_remove(bst_hash* hash, bst_key key);
+
+size_t bst_hash_bytes(bst_hash* hash);
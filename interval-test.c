@@ -0,0 +1,159 @@
+/*
+ * interval-test.c
+ * A simple test suite for the interval tree, checking overlap and stabbing
+ * queries against a linear scan, with many intervals sharing each start.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+
+#include "interval.h"
+#include "bst-util.h"
+
+
+int standard_tests()
+{
+    interval_tree* tree = interval_create();
+    interval out[8];
+
+    assert(interval_stab_count(tree, 5) == 0);
+    assert(interval_overlaps(tree, 0, 100, out, 8) == 0);
+
+    assert(interval_insert(tree, 5, 10) == 1);
+    assert(interval_insert(tree, 1, 3) == 1);
+    assert(interval_insert(tree, 8, 20) == 1);
+    assert(interval_insert(tree, 15, 16) == 1);
+    assert(interval_insert(tree, 12, 10) == 0);  // end before start
+    assert(interval_insert(tree, 5, 7) == 1);    // sharing a start is fine
+    assert(interval_insert(tree, 5, 7) == 0);    // but not a duplicate
+    assert(interval_length(tree) == 5);
+    assert(interval_search(tree, 5, 7) && interval_search(tree, 5, 10));
+    assert(!interval_search(tree, 5, 8) && !interval_search(tree, 6, 7));
+    printf("interval_insert passed\n");
+
+    assert(interval_stab_count(tree, 0) == 0);
+    assert(interval_stab_count(tree, 3) == 1);
+    assert(interval_stab_count(tree, 6) == 2);
+    assert(interval_stab_count(tree, 9) == 2);
+    assert(interval_stab_count(tree, 10) == 2);
+    assert(interval_stab_count(tree, 15) == 2);
+    assert(interval_stab_count(tree, 21) == 0);
+    printf("interval_stab_count passed\n");
+
+    assert(interval_stab(tree, 9, out, 8) == 2);
+    assert(out[0].start == 5 && out[0].end == 10);
+    assert(out[1].start == 8 && out[1].end == 20);
+
+    assert(interval_stab(tree, 7, out, 8) == 2);
+    assert(out[0].start == 5 && out[0].end == 10);
+    assert(out[1].start == 5 && out[1].end == 7);
+
+    assert(interval_overlaps(tree, 11, 14, out, 8) == 1);
+    assert(out[0].start == 8);
+    assert(interval_overlaps(tree, 0, 100, out, 2) == 5);
+    assert(out[0].start == 1 && out[1].start == 5);
+    printf("interval_overlaps passed\n");
+
+    assert(interval_delete(tree, 8, 20) == 1);
+    assert(interval_delete(tree, 8, 20) == 0);
+    assert(interval_stab_count(tree, 15) == 1);
+    assert(interval_overlaps(tree, 11, 14, out, 8) == 0);
+
+    // the start stays while one of its intervals is left
+    assert(interval_delete(tree, 5, 11) == 0);
+    assert(interval_delete(tree, 5, 10) == 1);
+    assert(interval_stab_count(tree, 9) == 0 && interval_stab_count(tree, 7) == 1);
+    assert(interval_delete(tree, 5, 7) == 1);
+    assert(interval_stab_count(tree, 7) == 0 && interval_length(tree) == 2);
+    printf("interval_delete passed\n");
+
+    interval_clear_destroy(tree);
+    return 0;
+}
+
+
+int random_tests(int n, int starts, int span)
+{
+    // n random intervals, over only a few starts, so that many share each
+    // one. present[start * span + length] records which are in the tree.
+    interval_tree* tree = interval_create();
+    char* present = calloc((size_t) starts * span, 1);
+    interval* out = malloc(sizeof(interval) * n);
+    int length = 0;
+
+    srand(time(NULL));
+    printf("Inserting and deleting %d random intervals over %d starts...\n", n, starts);
+    for (int i=0; i<n; i++) {
+        int start = rand() % starts;
+        int len = rand() % span;
+        int inserted = interval_insert(tree, start, start + len);
+        assert(inserted == !present[start * span + len]);
+        present[start * span + len] = 1;
+        length += inserted;
+
+        if (rand() % 3 == 0) {
+            start = rand() % starts;
+            len = rand() % span;
+            int deleted = interval_delete(tree, start, start + len);
+            assert(deleted == present[start * span + len]);
+            present[start * span + len] = 0;
+            length -= deleted;
+        }
+    }
+
+    assert(interval_length(tree) == length);
+    check_balance_factors(tree->starts->head);
+    check_balance_factors(tree->ends->head);
+
+    printf("Checking random queries against a scan...\n");
+    for (int i=0; i<1000; i++) {
+        int lo = rand() % (starts + span);
+        int hi = lo + rand() % 20;
+
+        int expected = 0;
+        int stabbed = 0;
+        for (int start=0; start<starts; start++) {
+            for (int len=0; len<span; len++) {
+                if (!present[start * span + len]) continue;
+                if (start <= hi && start + len >= lo) expected++;
+                if (start <= lo && start + len >= lo) stabbed++;
+            }
+        }
+
+        int found = interval_overlaps(tree, lo, hi, out, n);
+        assert(found == expected);
+        for (int j=0; j<found; j++) {
+            assert(out[j].start <= hi && out[j].end >= lo);
+            assert(present[out[j].start * span + out[j].end - out[j].start]);
+            assert(j == 0 || out[j-1].start < out[j].start
+                    || (out[j-1].start == out[j].start && out[j-1].end > out[j].end));
+        }
+
+        assert(interval_stab_count(tree, lo) == stabbed);
+        assert(interval_stab(tree, lo, out, n) == stabbed);
+    }
+
+    printf("Passed\n");
+
+    free(present);
+    free(out);
+    interval_clear_destroy(tree);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    standard_tests();
+    random_tests(5000, 5000, 50);
+    random_tests(20000, 100, 500);
+
+    return 0;
+}
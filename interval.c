@@ -0,0 +1,187 @@
+/*
+ * interval.c
+ *
+ * An interval tree built on the AVL tree.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "interval.h"
+
+#define MAX_END 0
+#define START_COUNT 1
+#define END_COUNT 0
+
+
+// A node is lifted once before its payload is set, with no ends yet.
+static bst_aggregate _lift_max_end(const bstnode* node)
+{
+    bst* ends = INTERVAL_ENDS(node);
+    return (ends) ? ends->rightmost->value : LLONG_MIN;
+}
+
+
+static bst_aggregate _lift_interval_count(const bstnode* node)
+{
+    bst* ends = INTERVAL_ENDS(node);
+    return (ends) ? ends->length : 0;
+}
+
+
+interval_tree* interval_create(void)
+{
+    static const bst_monoid start_monoids[] = {
+        BST_MONOID_MAX(_lift_max_end),
+        BST_MONOID_SUM(_lift_interval_count),
+    };
+    static const bst_monoid end_count[] = { BST_MONOID_SUM(bst_lift_payload) };
+
+    interval_tree* tree = malloc(sizeof(interval_tree));
+    if (!tree) {
+        fprintf(stderr, "MEMORY ERROR in interval_create. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    tree->starts = avl_create_augmented(start_monoids, 2);
+    tree->ends = avl_create_augmented(end_count, 1);
+
+    return tree;
+}
+
+
+int interval_insert(interval_tree* tree, int start, int end)
+{
+    if (end < start) {
+        return 0;
+    }
+
+    bstnode* start_node = avl_search(tree->starts, start);
+    if (start_node) {
+        if (!avl_insert(INTERVAL_ENDS(start_node), end)) {
+            return 0;
+        }
+
+        // the ends have changed, so the aggregates above have too
+        bst_update_path_aggregates(tree->starts, start_node);
+    } else {
+        bst* ends = avl_create();
+        avl_insert(ends, end);
+        avl_insert_payload(tree->starts, start, (bst_aggregate) (intptr_t) ends);
+    }
+
+    bstnode* end_node = avl_search(tree->ends, end);
+    if (end_node) {
+        bst_set_payload(tree->ends, end_node, BST_PAYLOAD(end_node) + 1);
+    } else {
+        avl_insert_payload(tree->ends, end, 1);
+    }
+
+    return 1;
+}
+
+
+int interval_delete(interval_tree* tree, int start, int end)
+{
+    bstnode* start_node = avl_search(tree->starts, start);
+    if (!start_node || !avl_delete(INTERVAL_ENDS(start_node), end)) {
+        return 0;
+    }
+
+    if (INTERVAL_ENDS(start_node)->length) {
+        bst_update_path_aggregates(tree->starts, start_node);
+    } else {
+        avl_clear_destroy(INTERVAL_ENDS(start_node));
+        avl_delete(tree->starts, start);
+    }
+
+    bstnode* end_node = avl_search(tree->ends, end);
+    if (BST_PAYLOAD(end_node) > 1) {
+        bst_set_payload(tree->ends, end_node, BST_PAYLOAD(end_node) - 1);
+    } else {
+        avl_delete(tree->ends, end);
+    }
+
+    return 1;
+}
+
+
+int interval_search(interval_tree* tree, int start, int end)
+{
+    bstnode* start_node = avl_search(tree->starts, start);
+    return start_node && avl_search(INTERVAL_ENDS(start_node), end);
+}
+
+
+static void _interval_overlaps(bstnode* head, int lo, int hi, interval* out,
+        int capacity, int* found)
+{
+    // nothing in this subtree reaches lo
+    if (head == NULL || BST_AGGREGATE(head, MAX_END) < lo) return;
+
+    _interval_overlaps(head->left, lo, hi, out, capacity, found);
+
+    // these intervals, and everything to their right, start after hi
+    if (head->value > hi) return;
+
+    // the ends are walked down from the largest, so that only those that
+    // are reported (and one more) are visited
+    for (bstnode* end = INTERVAL_ENDS(head)->rightmost; end && end->value >= lo; end = bst_node_prev(end)) {
+        if (*found < capacity)
+            out[*found] = (interval) {head->value, end->value};
+        (*found)++;
+    }
+
+    _interval_overlaps(head->right, lo, hi, out, capacity, found);
+}
+
+
+int interval_overlaps(interval_tree* tree, int lo, int hi, interval* out, int capacity)
+{
+    // Returns the number of intervals overlapping [lo, hi], and stores
+    // up to capacity of them in out, in order of start, and of end from the
+    // largest among those with the same start.
+    int found = 0;
+    _interval_overlaps(tree->starts->head, lo, hi, out, capacity, &found);
+
+    return found;
+}
+
+
+int interval_stab(interval_tree* tree, int point, interval* out, int capacity)
+{
+    return interval_overlaps(tree, point, point, out, capacity);
+}
+
+
+int interval_stab_count(interval_tree* tree, int point)
+{
+    // Every interval ending before point also starts before it, so the
+    // number of intervals containing point is the number starting at or
+    // before it, less the number that end before it.
+    int starts = (int) avl_range_aggregate(tree->starts, INT_MIN, point, START_COUNT);
+    int ended = (point == INT_MIN) ? 0 :
+        (int) avl_range_aggregate(tree->ends, INT_MIN, point - 1, END_COUNT);
+
+    return starts - ended;
+}
+
+
+bst_size interval_length(interval_tree* tree)
+{
+    return (tree->starts->head) ? (bst_size) BST_AGGREGATE(tree->starts->head, START_COUNT) : 0;
+}
+
+
+void interval_clear_destroy(interval_tree* tree)
+{
+    for (bstnode* node = bst_node_min(tree->starts->head); node; node = bst_node_next(node))
+        avl_clear_destroy(INTERVAL_ENDS(node));
+
+    avl_clear_destroy(tree->starts);
+    avl_clear_destroy(tree->ends);
+    free(tree);
+}
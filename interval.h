@@ -0,0 +1,61 @@
+/*
+ * interval.h
+ *
+ * An interval tree built on the AVL tree. Intervals are closed, [start, end],
+ * and are stored in an AVL tree keyed by their start. As any number of
+ * intervals can share a start, each node holds all of them, as a small AVL
+ * tree of their ends (its payload). Each node lifts the largest of these
+ * ends, and the number of them, into two monoid aggregates, the maximum end
+ * and the interval count within each subtree, maintained through bst_rotate
+ * and the AVL rebalancing like any other augmentation. Only an interval
+ * identical to one already in the tree is rejected.
+ *
+ * Reporting the intervals overlapping a range visits only the subtrees that
+ * contain a reported interval plus one boundary path. That is O(lg n + k) when
+ * the overlapping intervals are clustered in the tree, but O(lg n + k lg(n/k))
+ * in the worst case, where they are scattered among intervals that start
+ * early enough but end too soon. This falls short of O(lg n + k) for every
+ * query, which would take a priority search tree rather than the maximum end
+ * augmentation of the AVL tree. Counting the intervals that contain a point
+ * is O(lg n), using the interval counts and a second AVL tree of the end
+ * points.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include "avl.h"
+
+// the tree of ends of the intervals that start at a node of tree->starts
+#define INTERVAL_ENDS(node) ((bst*) (intptr_t) BST_PAYLOAD(node))
+
+typedef struct Interval {
+    int start;
+    int end;
+} interval;
+
+typedef struct IntervalTree {
+    // keyed by start, with the ends of the intervals starting there as
+    // payload, and max end and interval count aggregates
+    bst* starts;
+
+    // keyed by end, with the number of intervals ending there as payload
+    // and the sum of these as aggregate
+    bst* ends;
+} interval_tree;
+
+interval_tree* interval_create(void);
+
+int interval_insert(interval_tree* tree, int start, int end);
+int interval_delete(interval_tree* tree, int start, int end);
+int interval_search(interval_tree* tree, int start, int end);
+
+int interval_overlaps(interval_tree* tree, int lo, int hi, interval* out, int capacity);
+int interval_stab(interval_tree* tree, int point, interval* out, int capacity);
+int interval_stab_count(interval_tree* tree, int point);
+bst_size interval_length(interval_tree* tree);
+
+void interval_clear_destroy(interval_tree* tree);
@@ -1,10 +1,40 @@
 #pragma once
 
+#include <stdint.h>
+#include <inttypes.h>
+#include <limits.h>
+
 #define AVL_SUPPORT
+#define AGGREGATE_SUPPORT
+
+typedef long long bst_aggregate;
+
+// Keys, and sizes (lengths, ranks and indexes), are ints unless built with
+// BST_64BIT, which widens both to 64 bits for trees of more than 2^31 - 1
+// nodes, or with 64 bit keys. This costs 8 bytes per node (a bstnode goes
+// from 40 to 48 bytes, and its malloc chunk from 48 to 64), so it is a
+// separate configuration (make tests64) rather than the default. Both types
+// always have the same width, and sizes stay signed so that -1 can signal a
+// missing key.
+#ifdef BST_64BIT
+typedef int64_t bst_key;
+typedef int64_t bst_size;
+#define BST_KEY_FMT "%" PRId64
+#define BST_SIZE_FMT "%" PRId64
+#define BST_KEY_MIN INT64_MIN
+#define BST_KEY_MAX INT64_MAX
+#else
+typedef int bst_key;
+typedef int bst_size;
+#define BST_KEY_FMT "%d"
+#define BST_SIZE_FMT "%d"
+#define BST_KEY_MIN INT_MIN
+#define BST_KEY_MAX INT_MAX
+#endif
 
 typedef struct BSTNode {
-    int value;
-    int rank;
+    bst_key value;
+    bst_size rank;
     struct BSTNode* left;
     struct BSTNode* right;
     struct BSTNode* parent;
@@ -17,6 +47,18 @@ typedef struct BSTNode {
     // be used by any of the bst_ functions.
     int balance_factor;
 #endif
+
+    // Set on nodes removed by a lazy delete (see avl_set_lazy_delete). Dead
+    // nodes stay in the tree until they are compacted away, but aren't
+    // counted by rank, so they fit in what was padding.
+    unsigned char dead;
+
+#ifdef AGGREGATE_SUPPORT
+    // Trees created with an augmentation (see augment.h) allocate room at
+    // the end of each node for a payload, followed by one aggregate per
+    // monoid. This takes no space at all in nodes of other trees.
+    bst_aggregate aug[];
+#endif
 } bstnode;
 
 typedef struct Node {
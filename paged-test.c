@@ -0,0 +1,249 @@
+/*
+ * paged-test.c
+ * A simple test suite for the disk-resident tree, checking searches, ranks
+ * and bounds against a bitmap of the keys through random inserts and
+ * deletes, with a pool small enough that pages are constantly evicted and
+ * read back, and that a flushed tree reopens intact. Built with small pages
+ * (see the Makefile), so that a few thousand keys make a tree several
+ * levels deep.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+
+#include "paged.h"
+
+const char* path = "paged-test.pages";
+
+
+void check_tree(paged_tree* tree, char* contents, int range)
+{
+    bst_size index = 0;
+    for (int x=0; x<range; x++) {
+        bst_key bound;
+        bst_size rank;
+        int has_bound = paged_lower_bound(tree, x, &bound, &rank);
+        assert(rank == index + 1);
+
+        if (contents[x]) {
+            index++;
+            bst_key value;
+            assert(paged_search(tree, x));
+            assert(paged_get_index(tree, x) == index);
+            assert(paged_index(tree, index, &value) && value == x);
+            assert(has_bound && bound == x);
+        } else {
+            assert(!paged_search(tree, x));
+            assert(paged_get_index(tree, x) == -1);
+            assert(has_bound == (index < paged_length(tree)));
+            if (has_bound) assert(bound > x && contents[bound]);
+        }
+    }
+
+    bst_key value;
+    assert(index == paged_length(tree));
+    assert(!paged_index(tree, 0, &value) && !paged_index(tree, index + 1, &value));
+}
+
+
+int standard_tests()
+{
+    remove(path);
+    paged_tree* tree = paged_open(path, 0);
+    assert(tree && tree->pool_size == PAGED_MIN_POOL);
+    assert(paged_length(tree) == 0);
+
+    bst_key value;
+    bst_size rank;
+    assert(!paged_search(tree, 5));
+    assert(!paged_index(tree, 1, &value));
+    assert(!paged_lower_bound(tree, 5, &value, &rank) && rank == 1);
+    assert(!paged_pop_min(tree, &value) && !paged_pop_max(tree, &value));
+
+    printf("Checking ascending inserts...\n");
+    for (int i=0; i<1000; i++)
+        assert(paged_insert(tree, i));
+    assert(!paged_insert(tree, 500));
+    assert(paged_length(tree) == 1000 && tree->header.height > 2);
+
+    for (int i=0; i<1000; i++) {
+        assert(paged_get_index(tree, i) == i + 1);
+        assert(paged_index(tree, i + 1, &value) && value == i);
+    }
+
+    printf("Checking pops from either end...\n");
+    for (int i=0; i<500; i++) {
+        assert(paged_pop_min(tree, &value) && value == i);
+        assert(paged_pop_max(tree, &value) && value == 999 - i);
+    }
+    assert(paged_length(tree) == 0 && tree->header.height == 1);
+    assert(!paged_delete(tree, 5));
+
+    // the emptied pages are reused, rather than the file growing
+    uint32_t pages = tree->header.page_count;
+    for (int i=0; i<1000; i++)
+        assert(paged_insert(tree, i));
+    assert(tree->header.page_count == pages);
+
+    printf("Passed\n");
+
+    paged_close(tree);
+    remove(path);
+    return 0;
+}
+
+
+int random_tests(int range, int n, int pool_size)
+{
+    remove(path);
+    paged_tree* tree = paged_open(path, pool_size);
+    char* contents = calloc(range, 1);
+
+    srand(time(NULL));
+    printf("Checking random inserts and deletes over %d keys, with %d frames...\n",
+            range, pool_size);
+    for (int i=0; i<n; i++) {
+        int x = rand() % range;
+        int op = rand() % 8;
+
+        if (op < 4) {
+            assert(paged_insert(tree, x) == !contents[x]);
+            contents[x] = 1;
+        } else if (op < 7) {
+            assert(paged_delete(tree, x) == contents[x]);
+            contents[x] = 0;
+        } else if (paged_length(tree)) {
+            bst_key value;
+            bst_size rank = rand() % paged_length(tree) + 1;
+            assert(paged_delete_at(tree, rank, &value) && contents[value]);
+            contents[value] = 0;
+        }
+
+        if (i % (n / 8) == 0)
+            check_tree(tree, contents, range);
+    }
+    check_tree(tree, contents, range);
+
+    // a pool much smaller than the file has to keep going back to it
+    if (tree->header.page_count > 2 * (uint32_t) pool_size) {
+        assert(tree->io.reads > 0 && tree->io.writes > 0);
+        assert(paged_hit_rate(tree) > 0 && paged_hit_rate(tree) < 1);
+    }
+
+    printf("Checking the tree reopens intact...\n");
+    bst_size length = paged_length(tree);
+    paged_close(tree);
+
+    tree = paged_open(path, 4 * pool_size);
+    assert(tree && paged_length(tree) == length);
+    check_tree(tree, contents, range);
+
+    printf("Checking a pool large enough for the whole tree...\n");
+    paged_set_pool(tree, tree->header.page_count);
+    check_tree(tree, contents, range);
+    paged_reset_io(tree);
+    check_tree(tree, contents, range);
+    assert(tree->io.reads == 0 && tree->io.writes == 0);
+
+    printf("Passed\n");
+
+    paged_close(tree);
+    remove(path);
+    free(contents);
+    return 0;
+}
+
+
+int width_tests()
+{
+    // a file written with other key or count widths isn't opened
+    remove(path);
+    paged_tree* tree = paged_open(path, 0);
+    assert(tree->header.key_bytes == sizeof(bst_key));
+    assert(tree->header.size_bytes == sizeof(bst_size));
+    paged_close(tree);
+
+    printf("Checking a tree of other widths isn't reopened...\n");
+    FILE* file = fopen(path, "r+");
+    uint32_t other = 12 - sizeof(bst_key);
+    fseek(file, offsetof(paged_header, key_bytes), SEEK_SET);
+    fwrite(&other, sizeof(other), 1, file);
+    fclose(file);
+    assert(!paged_open(path, 0));
+
+    printf("Passed\n");
+
+    remove(path);
+    return 0;
+}
+
+
+int wide_key_tests(int n)
+{
+    // only meaningful with BST_64BIT (see nodes.h)
+#ifndef BST_64BIT
+    printf("Skipped %d wide keys: keys are %zu bytes\n", n, sizeof(bst_key));
+    return 0;
+#else
+    bst_key step = (bst_key) 1 << 33;
+
+    remove(path);
+    paged_tree* tree = paged_open(path, PAGED_MIN_POOL);
+
+    // keys spaced 2^33 apart, centered on zero, inserted from both ends
+    printf("Checking %d keys beyond 32 bits...\n", n);
+    for (int i=0; i<n / 2; i++) {
+        assert(paged_insert(tree, (i - n / 2) * step));
+        assert(paged_insert(tree, (n / 2 - i) * step));
+    }
+    assert(paged_insert(tree, 0) && paged_length(tree) == n + 1);
+
+    for (int i=0; i<=n; i++) {
+        bst_key key = (i - n / 2) * step, value, bound;
+        bst_size rank;
+        assert(paged_get_index(tree, key) == i + 1);
+        assert(paged_index(tree, i + 1, &value) && value == key);
+        assert(!paged_search(tree, key + 1));
+        assert(paged_lower_bound(tree, key - step / 2, &bound, &rank) && bound == key && rank == i + 1);
+    }
+
+    bst_key value;
+    assert(paged_pop_min(tree, &value) && value == -(n / 2) * step);
+    assert(paged_pop_max(tree, &value) && value == (n / 2) * step);
+
+    printf("Passed\n");
+
+    paged_close(tree);
+    remove(path);
+    return 0;
+#endif
+}
+
+
+int main(int argc, char **argv)
+{
+    standard_tests();
+    random_tests(100, 20000, PAGED_MIN_POOL);
+    random_tests(5000, 100000, PAGED_MIN_POOL);
+    random_tests(5000, 100000, 64);
+    width_tests();
+    wide_key_tests(5000);
+
+    // a file that isn't a paged tree isn't opened
+    FILE* other = fopen(path, "w");
+    fputs("not a tree", other);
+    fclose(other);
+    assert(!paged_open(path, 0));
+    remove(path);
+
+    return 0;
+}
@@ -0,0 +1,799 @@
+/*
+ * paged.c
+ *
+ * A disk-resident order-statistic B+ tree, behind a CLOCK buffer pool.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "paged.h"
+
+_Static_assert(sizeof(paged_page) <= PAGED_PAGE_SIZE, "paged_page must fit in a page");
+_Static_assert(sizeof(paged_header) <= PAGED_PAGE_SIZE, "paged_header must fit in a page");
+_Static_assert(PAGED_INNER_MAX >= 4, "inner pages must hold at least four children");
+
+// Below these, a page is refilled before a delete descends into it. Merging
+// two pages at the minimum then always fits in one, and splitting a full page
+// leaves both halves at least at the minimum.
+#define PAGED_LEAF_MIN (PAGED_LEAF_MAX / 2)
+#define PAGED_INNER_MIN (PAGED_INNER_MAX / 2)
+
+
+static void* _paged_malloc(size_t size)
+{
+    void* ptr = malloc(size);
+    if (!ptr) {
+        fprintf(stderr, "MEMORY ERROR in paged.c. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    return ptr;
+}
+
+
+static void _paged_transfer(paged_tree* tree, uint32_t page, void* data, int writing)
+{
+    char* bytes = data;
+    size_t done = 0;
+    off_t offset = (off_t) page * PAGED_PAGE_SIZE;
+
+    while (done < PAGED_PAGE_SIZE) {
+        ssize_t moved = (writing) ? pwrite(tree->fd, bytes + done, PAGED_PAGE_SIZE - done, offset + done)
+            : pread(tree->fd, bytes + done, PAGED_PAGE_SIZE - done, offset + done);
+        if (moved < 0 && errno == EINTR) continue;
+
+        // a page past the end of the file reads as zeroes
+        if (moved == 0 && !writing) {
+            memset(bytes + done, 0, PAGED_PAGE_SIZE - done);
+            break;
+        }
+
+        if (moved <= 0) {
+            fprintf(stderr, "I/O ERROR in paged.c. Unable to %s page %u.\n",
+                    (writing) ? "write" : "read", page);
+            exit(-1);
+        }
+
+        done += moved;
+    }
+
+    if (writing)
+        tree->io.writes++;
+    else
+        tree->io.reads++;
+}
+
+
+/*
+ * The buffer pool
+ */
+static int _table_slot(paged_tree* tree, uint32_t page)
+{
+    return (page * 2654435761u) & tree->table_mask;
+}
+
+
+static int _table_find(paged_tree* tree, uint32_t page)
+{
+    for (int slot = _table_slot(tree, page); tree->table[slot] != -1; slot = (slot + 1) & tree->table_mask) {
+        if (tree->frames[tree->table[slot]].page == page)
+            return tree->table[slot];
+    }
+
+    return -1;
+}
+
+
+static void _table_insert(paged_tree* tree, uint32_t page, int frame)
+{
+    int slot = _table_slot(tree, page);
+    while (tree->table[slot] != -1)
+        slot = (slot + 1) & tree->table_mask;
+
+    tree->table[slot] = frame;
+}
+
+
+static void _table_remove(paged_tree* tree, uint32_t page)
+{
+    int slot = _table_slot(tree, page);
+    while (tree->frames[tree->table[slot]].page != page)
+        slot = (slot + 1) & tree->table_mask;
+
+    // Shift back any later entry of the run that would otherwise become
+    // unreachable, rather than leaving a tombstone, as evictions would
+    // eventually fill the table with them.
+    int hole = slot;
+    for (slot = (slot + 1) & tree->table_mask; tree->table[slot] != -1; slot = (slot + 1) & tree->table_mask) {
+        int home = _table_slot(tree, tree->frames[tree->table[slot]].page);
+        if (((slot - home) & tree->table_mask) >= ((slot - hole) & tree->table_mask)) {
+            tree->table[hole] = tree->table[slot];
+            hole = slot;
+        }
+    }
+
+    tree->table[hole] = -1;
+}
+
+
+static void _pool_create(paged_tree* tree, int pool_size)
+{
+    if (pool_size < PAGED_MIN_POOL) pool_size = PAGED_MIN_POOL;
+
+    int table_size = 1;
+    while (table_size < 2 * pool_size)
+        table_size <<= 1;
+
+    tree->pages = _paged_malloc((size_t) pool_size * PAGED_PAGE_SIZE);
+    tree->frames = _paged_malloc(sizeof(paged_frame) * pool_size);
+    tree->table = _paged_malloc(sizeof(*tree->table) * table_size);
+    tree->pool_size = pool_size;
+    tree->table_mask = table_size - 1;
+    tree->clock_hand = 0;
+
+    memset(tree->frames, 0, sizeof(paged_frame) * pool_size);
+    memset(tree->table, -1, sizeof(*tree->table) * table_size);
+}
+
+
+static void _pool_destroy(paged_tree* tree)
+{
+    free(tree->pages);
+    free(tree->frames);
+    free(tree->table);
+}
+
+
+static paged_page* _frame_page(paged_tree* tree, int frame)
+{
+    return (paged_page*) (tree->pages + (size_t) frame * PAGED_PAGE_SIZE);
+}
+
+
+static int _frame_of(paged_tree* tree, paged_page* page)
+{
+    return ((char*) page - tree->pages) / PAGED_PAGE_SIZE;
+}
+
+
+static int _victim(paged_tree* tree)
+{
+    // Sweeps the clock hand over the frames, giving each referenced one a
+    // second chance. Two full turns are enough to find an unpinned frame, if
+    // there is one.
+    for (int tries=0; tries<2 * tree->pool_size; tries++) {
+        int frame = tree->clock_hand;
+        paged_frame* info = &tree->frames[frame];
+        tree->clock_hand = (tree->clock_hand + 1) % tree->pool_size;
+
+        if (!info->valid) return frame;
+        if (info->pins) continue;
+        if (info->referenced) {
+            info->referenced = 0;
+            continue;
+        }
+
+        if (info->dirty)
+            _paged_transfer(tree, info->page, _frame_page(tree, frame), 1);
+        _table_remove(tree, info->page);
+        info->valid = 0;
+        return frame;
+    }
+
+    fprintf(stderr, "POOL ERROR in paged.c. Every frame is pinned.\n");
+    exit(-1);
+}
+
+
+static paged_page* _claim(paged_tree* tree, uint32_t page, int reading)
+{
+    int frame = _victim(tree);
+    paged_frame* info = &tree->frames[frame];
+
+    if (reading)
+        _paged_transfer(tree, page, _frame_page(tree, frame), 0);
+
+    info->page = page;
+    info->pins = 1;
+    info->valid = 1;
+    info->dirty = !reading;
+    info->referenced = 1;
+    _table_insert(tree, page, frame);
+
+    return _frame_page(tree, frame);
+}
+
+
+static paged_page* _fetch(paged_tree* tree, uint32_t page)
+{
+    // returns the page pinned in the pool, until the matching _unpin
+    int frame = _table_find(tree, page);
+    if (frame == -1)
+        return _claim(tree, page, 1);
+
+    tree->io.hits++;
+    tree->frames[frame].pins++;
+    tree->frames[frame].referenced = 1;
+    return _frame_page(tree, frame);
+}
+
+
+static void _unpin(paged_tree* tree, paged_page* page)
+{
+    tree->frames[_frame_of(tree, page)].pins--;
+}
+
+
+static void _dirty(paged_tree* tree, paged_page* page)
+{
+    tree->frames[_frame_of(tree, page)].dirty = 1;
+}
+
+
+static paged_page* _new_page(paged_tree* tree, uint32_t* number, int leaf)
+{
+    // reuses a released page if there is one, and otherwise extends the file
+    paged_page* page;
+    if (tree->header.free_list) {
+        *number = tree->header.free_list;
+        page = _fetch(tree, *number);
+        tree->header.free_list = page->next;
+        _dirty(tree, page);
+    } else {
+        *number = tree->header.page_count++;
+        page = _claim(tree, *number, 0);
+    }
+
+    memset(page, 0, PAGED_PAGE_SIZE);
+    page->leaf = leaf;
+    return page;
+}
+
+
+static void _release_page(paged_tree* tree, uint32_t number, paged_page* page)
+{
+    page->next = tree->header.free_list;
+    tree->header.free_list = number;
+    _dirty(tree, page);
+    _unpin(tree, page);
+}
+
+
+paged_tree* paged_open(const char* path, int pool_size)
+{
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return NULL;
+
+    paged_tree* tree = _paged_malloc(sizeof(paged_tree));
+    memset(tree, 0, sizeof(paged_tree));
+    tree->fd = fd;
+
+    off_t size = lseek(fd, 0, SEEK_END);
+    if (size > 0) {
+        paged_page* buffer = _paged_malloc(PAGED_PAGE_SIZE);
+        _paged_transfer(tree, 0, buffer, 0);
+        memcpy(&tree->header, buffer, sizeof(paged_header));
+        free(buffer);
+
+        // a file can only be reopened by a build with the same page size and
+        // the same key and count widths
+        if (tree->header.magic != PAGED_MAGIC || tree->header.page_size != PAGED_PAGE_SIZE
+                || tree->header.key_bytes != sizeof(bst_key) || tree->header.size_bytes != sizeof(bst_size)) {
+            close(fd);
+            free(tree);
+            return NULL;
+        }
+
+        _pool_create(tree, pool_size);
+    } else {
+        tree->header = (paged_header) {PAGED_MAGIC, PAGED_PAGE_SIZE, sizeof(bst_key), sizeof(bst_size), 0, 1, 1, 0, 0};
+        _pool_create(tree, pool_size);
+
+        paged_page* root = _new_page(tree, &tree->header.root, 1);
+        _unpin(tree, root);
+        paged_flush(tree);
+    }
+
+    paged_reset_io(tree);
+    return tree;
+}
+
+
+void paged_flush(paged_tree* tree)
+{
+    for (int frame=0; frame<tree->pool_size; frame++) {
+        paged_frame* info = &tree->frames[frame];
+        if (info->valid && info->dirty) {
+            _paged_transfer(tree, info->page, _frame_page(tree, frame), 1);
+            info->dirty = 0;
+        }
+    }
+
+    char* buffer = _paged_malloc(PAGED_PAGE_SIZE);
+    memset(buffer, 0, PAGED_PAGE_SIZE);
+    memcpy(buffer, &tree->header, sizeof(paged_header));
+    _paged_transfer(tree, 0, buffer, 1);
+    free(buffer);
+}
+
+
+void paged_set_pool(paged_tree* tree, int pool_size)
+{
+    // writes everything back, so the new pool starts out cold
+    paged_flush(tree);
+    _pool_destroy(tree);
+    _pool_create(tree, pool_size);
+}
+
+
+void paged_close(paged_tree* tree)
+{
+    paged_flush(tree);
+    close(tree->fd);
+    _pool_destroy(tree);
+    free(tree);
+}
+
+
+/*
+ * Searching
+ */
+static int _leaf_position(paged_page* leaf, bst_key value)
+{
+    // the number of keys in the leaf less than value
+    int lo = 0, hi = leaf->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (leaf->keys[mid] < value)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+
+static int _child_position(paged_page* page, bst_key value)
+{
+    // the child whose range holds value: the number of separators at most
+    // value
+    int lo = 0, hi = page->count - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (page->inner.keys[mid] <= value)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+
+static paged_page* _descend(paged_tree* tree, bst_key value, bst_size* before)
+{
+    // Returns the leaf whose range holds value, pinned. If before isn't
+    // NULL, it is set to the number of keys in the leaves to its left.
+    bst_size skipped = 0;
+    paged_page* page = _fetch(tree, tree->header.root);
+
+    while (!page->leaf) {
+        int i = _child_position(page, value);
+        for (int j=0; before && j<i; j++)
+            skipped += page->inner.counts[j];
+
+        uint32_t child = page->inner.children[i];
+        _unpin(tree, page);
+        page = _fetch(tree, child);
+    }
+
+    if (before) *before = skipped;
+    return page;
+}
+
+
+int paged_search(paged_tree* tree, bst_key value)
+{
+    paged_page* leaf = _descend(tree, value, NULL);
+    int i = _leaf_position(leaf, value);
+    int found = (i < leaf->count && leaf->keys[i] == value);
+
+    _unpin(tree, leaf);
+    return found;
+}
+
+
+bst_size paged_get_index(paged_tree* tree, bst_key value)
+{
+    bst_size before;
+    paged_page* leaf = _descend(tree, value, &before);
+    int i = _leaf_position(leaf, value);
+    int found = (i < leaf->count && leaf->keys[i] == value);
+
+    _unpin(tree, leaf);
+    return (found) ? before + i + 1 : -1;
+}
+
+
+int paged_index(paged_tree* tree, bst_size index, bst_key* value)
+{
+    if (index < 1 || index > tree->header.length)
+        return 0;
+
+    paged_page* page = _fetch(tree, tree->header.root);
+    while (!page->leaf) {
+        int i = 0;
+        while (index > page->inner.counts[i])
+            index -= page->inner.counts[i++];
+
+        uint32_t child = page->inner.children[i];
+        _unpin(tree, page);
+        page = _fetch(tree, child);
+    }
+
+    *value = page->keys[index - 1];
+    _unpin(tree, page);
+    return 1;
+}
+
+
+int paged_lower_bound(paged_tree* tree, bst_key value, bst_key* bound, bst_size* rank)
+{
+    // Returns whether any key is at least value, setting bound to the least
+    // such key, and rank to its index (or one past the last index, if there
+    // isn't one).
+    bst_size before;
+    paged_page* leaf = _descend(tree, value, &before);
+    int i = _leaf_position(leaf, value);
+    int in_leaf = (i < leaf->count);
+
+    if (in_leaf) *bound = leaf->keys[i];
+    _unpin(tree, leaf);
+
+    // Otherwise the bound (if any) heads the next leaf, which is found by
+    // its index rather than keeping sibling links up to date.
+    *rank = before + i + 1;
+    return in_leaf || paged_index(tree, *rank, bound);
+}
+
+
+bst_size paged_length(paged_tree* tree)
+{
+    return tree->header.length;
+}
+
+
+/*
+ * Inserting
+ */
+static int _full(paged_page* page)
+{
+    return page->count == ((page->leaf) ? PAGED_LEAF_MAX : PAGED_INNER_MAX);
+}
+
+
+static paged_page* _split_child(paged_tree* tree, paged_page* parent, int i, paged_page* child)
+{
+    // Moves the upper half of the full child i of parent (which isn't full)
+    // to a new page, linked in as child i + 1, which is returned pinned.
+    uint32_t number;
+    paged_page* sibling = _new_page(tree, &number, child->leaf);
+    int keep = child->count / 2;
+    int moved = child->count - keep;
+    bst_key separator;
+    bst_size moved_keys = 0;
+
+    if (child->leaf) {
+        memcpy(sibling->keys, child->keys + keep, sizeof(bst_key) * moved);
+        separator = sibling->keys[0];
+        moved_keys = moved;
+    } else {
+        // the separator between the halves moves up to the parent
+        separator = child->inner.keys[keep - 1];
+        memcpy(sibling->inner.keys, child->inner.keys + keep, sizeof(bst_key) * (moved - 1));
+        memcpy(sibling->inner.children, child->inner.children + keep, sizeof(uint32_t) * moved);
+        memcpy(sibling->inner.counts, child->inner.counts + keep, sizeof(bst_size) * moved);
+        for (int j=0; j<moved; j++)
+            moved_keys += sibling->inner.counts[j];
+    }
+
+    sibling->count = moved;
+    child->count = keep;
+
+    int after = parent->count - 1 - i;
+    memmove(parent->inner.keys + i + 1, parent->inner.keys + i, sizeof(bst_key) * after);
+    memmove(parent->inner.children + i + 2, parent->inner.children + i + 1, sizeof(uint32_t) * after);
+    memmove(parent->inner.counts + i + 2, parent->inner.counts + i + 1, sizeof(bst_size) * after);
+    parent->inner.keys[i] = separator;
+    parent->inner.children[i + 1] = number;
+    parent->inner.counts[i + 1] = moved_keys;
+    parent->inner.counts[i] -= moved_keys;
+    parent->count++;
+
+    _dirty(tree, parent);
+    _dirty(tree, child);
+    return sibling;
+}
+
+
+int paged_insert(paged_tree* tree, bst_key value)
+{
+    // The search first means the counts can be raised on the way down.
+    // Its pages are left in the pool, so it costs no extra reads.
+    if (paged_search(tree, value))
+        return 0;
+
+    paged_page* page = _fetch(tree, tree->header.root);
+    if (_full(page)) {
+        uint32_t number;
+        paged_page* root = _new_page(tree, &number, 0);
+        root->count = 1;
+        root->inner.children[0] = tree->header.root;
+        root->inner.counts[0] = tree->header.length;
+
+        _unpin(tree, _split_child(tree, root, 0, page));
+        _unpin(tree, page);
+
+        tree->header.root = number;
+        tree->header.height++;
+        page = root;
+    }
+
+    while (!page->leaf) {
+        int i = _child_position(page, value);
+        paged_page* child = _fetch(tree, page->inner.children[i]);
+
+        if (_full(child)) {
+            paged_page* sibling = _split_child(tree, page, i, child);
+            if (value >= page->inner.keys[i]) {
+                _unpin(tree, child);
+                child = sibling;
+                i++;
+            } else {
+                _unpin(tree, sibling);
+            }
+        }
+
+        page->inner.counts[i]++;
+        _dirty(tree, page);
+        _unpin(tree, page);
+        page = child;
+    }
+
+    int i = _leaf_position(page, value);
+    memmove(page->keys + i + 1, page->keys + i, sizeof(bst_key) * (page->count - i));
+    page->keys[i] = value;
+    page->count++;
+    _dirty(tree, page);
+    _unpin(tree, page);
+
+    tree->header.length++;
+    return 1;
+}
+
+
+/*
+ * Deleting
+ */
+static int _minimal(paged_page* page)
+{
+    return page->count <= ((page->leaf) ? PAGED_LEAF_MIN : PAGED_INNER_MIN);
+}
+
+
+static void _borrow_left(paged_tree* tree, paged_page* parent, int i, paged_page* left, paged_page* child)
+{
+    // moves the last entry of child i - 1 to the front of child i
+    bst_size moved_keys = 1;
+
+    if (child->leaf) {
+        memmove(child->keys + 1, child->keys, sizeof(bst_key) * child->count);
+        child->keys[0] = left->keys[left->count - 1];
+        parent->inner.keys[i - 1] = child->keys[0];
+    } else {
+        memmove(child->inner.keys + 1, child->inner.keys, sizeof(bst_key) * (child->count - 1));
+        memmove(child->inner.children + 1, child->inner.children, sizeof(uint32_t) * child->count);
+        memmove(child->inner.counts + 1, child->inner.counts, sizeof(bst_size) * child->count);
+
+        // the separator rotates down into child, and left's last one up
+        child->inner.keys[0] = parent->inner.keys[i - 1];
+        child->inner.children[0] = left->inner.children[left->count - 1];
+        child->inner.counts[0] = left->inner.counts[left->count - 1];
+        parent->inner.keys[i - 1] = left->inner.keys[left->count - 2];
+        moved_keys = child->inner.counts[0];
+    }
+
+    left->count--;
+    child->count++;
+    parent->inner.counts[i - 1] -= moved_keys;
+    parent->inner.counts[i] += moved_keys;
+
+    _dirty(tree, parent);
+    _dirty(tree, left);
+    _dirty(tree, child);
+}
+
+
+static void _borrow_right(paged_tree* tree, paged_page* parent, int i, paged_page* child, paged_page* right)
+{
+    // moves the first entry of child i + 1 to the end of child i
+    bst_size moved_keys = 1;
+
+    if (child->leaf) {
+        child->keys[child->count] = right->keys[0];
+        memmove(right->keys, right->keys + 1, sizeof(bst_key) * (right->count - 1));
+        parent->inner.keys[i] = right->keys[0];
+    } else {
+        child->inner.keys[child->count - 1] = parent->inner.keys[i];
+        child->inner.children[child->count] = right->inner.children[0];
+        child->inner.counts[child->count] = right->inner.counts[0];
+        parent->inner.keys[i] = right->inner.keys[0];
+        moved_keys = right->inner.counts[0];
+
+        memmove(right->inner.keys, right->inner.keys + 1, sizeof(bst_key) * (right->count - 2));
+        memmove(right->inner.children, right->inner.children + 1, sizeof(uint32_t) * (right->count - 1));
+        memmove(right->inner.counts, right->inner.counts + 1, sizeof(bst_size) * (right->count - 1));
+    }
+
+    right->count--;
+    child->count++;
+    parent->inner.counts[i] += moved_keys;
+    parent->inner.counts[i + 1] -= moved_keys;
+
+    _dirty(tree, parent);
+    _dirty(tree, child);
+    _dirty(tree, right);
+}
+
+
+static void _merge(paged_tree* tree, paged_page* parent, int i, paged_page* left, paged_page* right)
+{
+    // Appends child i + 1 to child i, and releases its page (and the pin on
+    // it).
+    if (left->leaf) {
+        memcpy(left->keys + left->count, right->keys, sizeof(bst_key) * right->count);
+    } else {
+        left->inner.keys[left->count - 1] = parent->inner.keys[i];
+        memcpy(left->inner.keys + left->count, right->inner.keys, sizeof(bst_key) * (right->count - 1));
+        memcpy(left->inner.children + left->count, right->inner.children, sizeof(uint32_t) * right->count);
+        memcpy(left->inner.counts + left->count, right->inner.counts, sizeof(bst_size) * right->count);
+    }
+
+    left->count += right->count;
+    _release_page(tree, parent->inner.children[i + 1], right);
+
+    int after = parent->count - 2 - i;
+    parent->inner.counts[i] += parent->inner.counts[i + 1];
+    memmove(parent->inner.keys + i, parent->inner.keys + i + 1, sizeof(bst_key) * after);
+    memmove(parent->inner.children + i + 1, parent->inner.children + i + 2, sizeof(uint32_t) * after);
+    memmove(parent->inner.counts + i + 1, parent->inner.counts + i + 2, sizeof(bst_size) * after);
+    parent->count--;
+
+    _dirty(tree, parent);
+    _dirty(tree, left);
+}
+
+
+static paged_page* _refill(paged_tree* tree, paged_page* parent, int* i, paged_page* child)
+{
+    // Gives the minimal child i of parent an extra entry, from a sibling if
+    // either can spare one, and otherwise by merging it with one. Returns
+    // the page now covering child i's range (with i updated to match),
+    // pinned; the other pages are unpinned.
+    paged_page* left = (*i > 0) ? _fetch(tree, parent->inner.children[*i - 1]) : NULL;
+    if (left && !_minimal(left)) {
+        _borrow_left(tree, parent, *i, left, child);
+        _unpin(tree, left);
+        return child;
+    }
+
+    paged_page* right = (*i + 1 < parent->count) ? _fetch(tree, parent->inner.children[*i + 1]) : NULL;
+    if (right && !_minimal(right)) {
+        _borrow_right(tree, parent, *i, child, right);
+        _unpin(tree, right);
+        if (left) _unpin(tree, left);
+        return child;
+    }
+
+    if (left) {
+        if (right) _unpin(tree, right);
+        (*i)--;
+        _merge(tree, parent, *i, left, child);
+        return left;
+    }
+
+    _merge(tree, parent, *i, child, right);
+    return child;
+}
+
+
+static void _paged_remove(paged_tree* tree, bst_key value)
+{
+    // removes value, which must be in the tree
+    paged_page* page = _fetch(tree, tree->header.root);
+
+    while (!page->leaf) {
+        int i = _child_position(page, value);
+        paged_page* child = _fetch(tree, page->inner.children[i]);
+        if (_minimal(child))
+            child = _refill(tree, page, &i, child);
+
+        page->inner.counts[i]--;
+        _dirty(tree, page);
+
+        // a root left with a single child is replaced by it
+        if (page->count == 1) {
+            uint32_t old_root = tree->header.root;
+            tree->header.root = page->inner.children[0];
+            tree->header.height--;
+            _release_page(tree, old_root, page);
+        } else {
+            _unpin(tree, page);
+        }
+
+        page = child;
+    }
+
+    int i = _leaf_position(page, value);
+    memmove(page->keys + i, page->keys + i + 1, sizeof(bst_key) * (page->count - i - 1));
+    page->count--;
+    _dirty(tree, page);
+    _unpin(tree, page);
+
+    tree->header.length--;
+}
+
+
+int paged_delete(paged_tree* tree, bst_key value)
+{
+    // as with inserts, the search lets the counts be lowered on the way down
+    if (!paged_search(tree, value))
+        return 0;
+
+    _paged_remove(tree, value);
+    return 1;
+}
+
+
+int paged_delete_at(paged_tree* tree, bst_size rank, bst_key* value)
+{
+    if (!paged_index(tree, rank, value))
+        return 0;
+
+    _paged_remove(tree, *value);
+    return 1;
+}
+
+
+int paged_pop_min(paged_tree* tree, bst_key* value)
+{
+    return paged_delete_at(tree, 1, value);
+}
+
+
+int paged_pop_max(paged_tree* tree, bst_key* value)
+{
+    return paged_delete_at(tree, tree->header.length, value);
+}
+
+
+double paged_hit_rate(paged_tree* tree)
+{
+    long long requests = tree->io.hits + tree->io.reads;
+    return (requests) ? (double) tree->io.hits / requests : 0;
+}
+
+
+void paged_reset_io(paged_tree* tree)
+{
+    memset(&tree->io, 0, sizeof(paged_io));
+}
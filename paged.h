@@ -0,0 +1,142 @@
+/*
+ * paged.h
+ *
+ * An order-statistic tree for key sets larger than memory. The keys live in
+ * a file, as a B+ tree of fixed-size pages, and only a buffer pool of a set
+ * number of pages is held in memory at once. Pages are read and written with
+ * pread and pwrite, so any local filesystem will do.
+ *
+ * A B+ tree is used rather than AVL nodes grouped into pages, as a descent
+ * then touches one page per level: with 4K pages, a leaf holds 1022 keys and
+ * an inner page 340 children (511 and 204 with BST_64BIT), so even a billion
+ * keys are four pages deep. In place of a rank, each inner page keeps the
+ * number of keys under every one of its children, so index and get_index
+ * still take a single descent. Keys and counts are a bst_key and a bst_size
+ * on disk, as in memory, so a 64 bit build isn't limited to 2^31 - 1 keys;
+ * the header page records both widths, and a file is only reopened by a
+ * build that matches them. Inserts split full pages, and deletes refill
+ * minimal ones, on the way down, so no operation has to climb back up the
+ * tree.
+ *
+ * The pool is managed with the CLOCK algorithm (an approximation of LRU
+ * which only needs a reference bit per frame). Dirty pages are written back
+ * when they are evicted, and by paged_flush, which also writes the header
+ * page, so that a closed tree can be reopened with paged_open. Durability
+ * beyond that (an fsync) is left to the caller.
+ *
+ * The counters in tree->io record the pages requested from the pool, how
+ * many of those had to be read from the file, and the pages written back.
+ * As the file goes through the kernel's page cache, the reads are a better
+ * measure of the cost of a workload than its running time.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include "nodes.h"
+
+#ifndef PAGED_PAGE_SIZE
+#define PAGED_PAGE_SIZE 4096
+#endif
+
+// the fewest frames a pool can have, as a delete can hold a page and three
+// of its children at once
+#define PAGED_MIN_POOL 8
+
+#define PAGED_MAGIC 0x50414745
+
+// the most keys in a leaf, and children of an inner page
+#define PAGED_LEAF_MAX ((int) ((PAGED_PAGE_SIZE - 8) / sizeof(bst_key)))
+#define PAGED_INNER_MAX ((int) ((PAGED_PAGE_SIZE - 8) / (sizeof(bst_key) + sizeof(bst_size) + sizeof(uint32_t))))
+
+typedef struct PagedPage {
+    uint16_t leaf;
+
+    // keys in a leaf, or children of an inner page
+    uint16_t count;
+
+    // the next page on the free list, for pages that have been released
+    uint32_t next;
+
+    union {
+        bst_key keys[PAGED_LEAF_MAX];
+
+        // keys[i] separates children[i] and children[i + 1], so that a child
+        // holds the keys at least the separator on its left and less than
+        // the one on its right. counts[i] is the number of keys under
+        // children[i]. The counts come before the children so that they
+        // need no padding when they're wider.
+        struct {
+            bst_key keys[PAGED_INNER_MAX];
+            bst_size counts[PAGED_INNER_MAX];
+            uint32_t children[PAGED_INNER_MAX];
+        } inner;
+    };
+} paged_page;
+
+// page 0 of the file, which records the widths of the keys and counts, as
+// well as the page size, that the pages were written with
+typedef struct PagedHeader {
+    uint32_t magic;
+    uint32_t page_size;
+    uint32_t key_bytes;
+    uint32_t size_bytes;
+    uint32_t root;
+    uint32_t height;
+    uint32_t page_count;
+    uint32_t free_list;
+    bst_size length;
+} paged_header;
+
+typedef struct PagedFrame {
+    uint32_t page;
+    int pins;
+    unsigned char valid;
+    unsigned char dirty;
+    unsigned char referenced;
+} paged_frame;
+
+typedef struct PagedIO {
+    long long hits;
+    long long reads;
+    long long writes;
+} paged_io;
+
+typedef struct PagedTree {
+    int fd;
+    paged_header header;
+
+    // the buffer pool: pool_size pages, with a frame describing each, and an
+    // open addressing table from page numbers to frames
+    char* pages;
+    paged_frame* frames;
+    int pool_size;
+    int clock_hand;
+    int* table;
+    int table_mask;
+
+    paged_io io;
+} paged_tree;
+
+paged_tree* paged_open(const char* path, int pool_size);
+void paged_set_pool(paged_tree* tree, int pool_size);
+void paged_flush(paged_tree* tree);
+void paged_close(paged_tree* tree);
+
+int paged_insert(paged_tree* tree, bst_key value);
+int paged_delete(paged_tree* tree, bst_key value);
+int paged_delete_at(paged_tree* tree, bst_size rank, bst_key* value);
+int paged_pop_min(paged_tree* tree, bst_key* value);
+int paged_pop_max(paged_tree* tree, bst_key* value);
+
+int paged_search(paged_tree* tree, bst_key value);
+int paged_index(paged_tree* tree, bst_size index, bst_key* value);
+bst_size paged_get_index(paged_tree* tree, bst_key value);
+int paged_lower_bound(paged_tree* tree, bst_key value, bst_key* bound, bst_size* rank);
+bst_size paged_length(paged_tree* tree);
+
+double paged_hit_rate(paged_tree* tree);
+void paged_reset_io(paged_tree* tree);
@@ -0,0 +1,208 @@
+/*
+ * parallel-test.c
+ * A simple test suite for the multi-threaded AVL operations.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+
+#include "parallel.h"
+#include "bst-util.h"
+
+
+int compare_keys(const void* a, const void* b)
+{
+    bst_key x = *(const bst_key*) a;
+    bst_key y = *(const bst_key*) b;
+
+    return (x > y) - (x < y);
+}
+
+
+void check_avl(bst* tree)
+{
+    check_bst_ordering(tree);
+    check_parent_links(tree->head);
+    check_extremes(tree);
+    assert(check_subtree_ranks(tree->head) == tree->length);
+    assert(check_balance_factors(tree->head) == tree->height);
+    check_strict_balance(tree->head, 0);
+}
+
+
+int build_tests(int n)
+{
+    bst_key* keys = malloc(sizeof(bst_key) * n);
+    bst_key* sorted = malloc(sizeof(bst_key) * n);
+
+    srand(time(NULL));
+    for (int i=0; i<n; i++)
+        keys[i] = rand() % n - n / 4;
+
+    memcpy(sorted, keys, sizeof(bst_key) * n);
+    qsort(sorted, n, sizeof(bst_key), compare_keys);
+    int unique = 0;
+    for (int i=0; i<n; i++) {
+        if (i == 0 || sorted[i] != sorted[i - 1])
+            sorted[unique++] = sorted[i];
+    }
+
+    int threads[] = {1, 2, 4, 7, 16};
+    for (int t=0; t<5; t++) {
+        printf("Building from %d keys with %d threads...\n", n, threads[t]);
+        bst* tree = avl_build_parallel(keys, n, threads[t]);
+
+        assert(tree->length == unique);
+        check_avl(tree);
+        for (int i=0; i<unique; i++)
+            assert(avl_index(tree, i + 1)->value == sorted[i]);
+
+        // the result should be usable as an ordinary AVL tree
+        for (int i=0; i<1000; i++) {
+            avl_insert(tree, rand() % (2 * n));
+            avl_delete(tree, rand() % (2 * n));
+        }
+        check_avl(tree);
+
+        avl_clear_destroy(tree);
+    }
+
+    bst* empty = avl_build_parallel(keys, 0, 4);
+    assert(empty->length == 0 && !empty->head);
+    avl_clear_destroy(empty);
+
+    bst* small = avl_build_parallel(keys, 3, 4);
+    check_avl(small);
+    avl_clear_destroy(small);
+
+    printf("Passed\n");
+
+    free(keys);
+    free(sorted);
+    return 0;
+}
+
+
+int executor_tests(int n)
+{
+    bst* tree = avl_create();
+    srand(time(NULL));
+    for (int i=0; i<n; i++)
+        avl_insert(tree, rand() % (4 * n));
+
+    int count = 50000;
+    tree_query* queries = malloc(sizeof(tree_query) * count);
+    query_result* results = malloc(sizeof(query_result) * count);
+
+    for (int i=0; i<count; i++) {
+        queries[i].type = rand() % 4;
+        queries[i].arg = (queries[i].type == QUERY_INDEX) ?
+            rand() % (n + 2) - 1 : rand() % (4 * n + 2) - 1;
+        queries[i].arg2 = queries[i].arg + rand() % 200 - 20;
+    }
+
+    int threads[] = {1, 3, 8};
+    for (int t=0; t<3; t++) {
+        printf("Executing %d queries with %d threads...\n", count, threads[t]);
+        memset(results, 0, sizeof(query_result) * count);
+        avl_execute_queries(tree, queries, count, results, threads[t]);
+
+        for (int i=0; i<count; i++) {
+            bst_key arg = queries[i].arg;
+            bst_key arg2 = queries[i].arg2;
+
+            switch (queries[i].type) {
+                case QUERY_SEARCH:
+                    assert(results[i].node == avl_search(tree, arg));
+                    break;
+                case QUERY_INDEX:
+                    assert(results[i].node == avl_index(tree, arg));
+                    break;
+                case QUERY_GET_INDEX:
+                    assert(results[i].count == avl_get_index(tree, arg));
+                    break;
+                case QUERY_RANGE_COUNT: {
+                    bst_size expected = 0;
+                    for (bst_key x=arg; x<=arg2; x++)
+                        expected += (avl_search(tree, x) != NULL);
+                    assert(results[i].count == expected);
+                    break;
+                }
+            }
+        }
+    }
+
+    printf("Passed\n");
+
+    free(queries);
+    free(results);
+    avl_clear_destroy(tree);
+    return 0;
+}
+
+
+int wide_key_tests(int n)
+{
+    // only meaningful with BST_64BIT (see nodes.h)
+#ifndef BST_64BIT
+    printf("Skipped %d wide keys: keys are %zu bytes\n", n, sizeof(bst_key));
+    return 0;
+#else
+    bst_key step = (bst_key) 1 << 33;
+    bst_key* keys = malloc(sizeof(bst_key) * n);
+
+    // keys spaced 2^33 apart, centered on zero, in a random order
+    srand(time(NULL));
+    for (int i=0; i<n; i++)
+        keys[i] = (i - n / 2) * step;
+    for (int i=n-1; i>0; i--) {
+        int j = rand() % (i + 1);
+        bst_key tmp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+
+    printf("Building from %d keys beyond 32 bits...\n", n);
+    bst* tree = avl_build_parallel(keys, n, 4);
+    assert(tree->length == n);
+    check_avl(tree);
+    for (int i=0; i<n; i++)
+        assert(avl_index(tree, i + 1)->value == (i - n / 2) * step);
+
+    printf("Executing queries on them...\n");
+    tree_query queries[3] = {
+        {QUERY_SEARCH, (n / 4) * step, 0},
+        {QUERY_GET_INDEX, (n / 4) * step, 0},
+        {QUERY_RANGE_COUNT, -step, (bst_key) n * step},
+    };
+    query_result results[3];
+    avl_execute_queries(tree, queries, 3, results, 2);
+
+    assert(results[0].node && results[0].node->value == (n / 4) * step);
+    assert(results[1].count == n / 4 + n / 2 + 1);
+    assert(results[2].count == n - n / 2 + 1);
+
+    printf("Passed\n");
+
+    free(keys);
+    avl_clear_destroy(tree);
+    return 0;
+#endif
+}
+
+
+int main(int argc, char **argv)
+{
+    build_tests(100000);
+    executor_tests(10000);
+    wide_key_tests(10000);
+
+    return 0;
+}
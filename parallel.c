@@ -0,0 +1,383 @@
+/*
+ * parallel.c
+ *
+ * Multi-threaded operations on AVL trees.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "parallel.h"
+
+// keys sampled per thread when picking sample sort splitters
+#define SAMPLES_PER_THREAD 64
+
+
+static void* _parallel_malloc(size_t size)
+{
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr) {
+        fprintf(stderr, "MEMORY ERROR in parallel.c. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    return ptr;
+}
+
+
+static void _run_threads(int nthreads, void* (*work)(void*), void* args, size_t arg_size)
+{
+    // runs work on each of the nthreads argument structures in args, the
+    // first on the calling thread, and waits for them all to finish.
+    pthread_t threads[PARALLEL_MAX_THREADS];
+
+    for (int t=1; t<nthreads; t++) {
+        if (pthread_create(&threads[t], NULL, work, (char*) args + t * arg_size)) {
+            fprintf(stderr, "ERROR in _run_threads. Thread creation failed.\n");
+            exit(-1);
+        }
+    }
+
+    work(args);
+
+    for (int t=1; t<nthreads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+}
+
+
+static int _compare_keys(const void* a, const void* b)
+{
+    bst_key x = *(const bst_key*) a;
+    bst_key y = *(const bst_key*) b;
+
+    return (x > y) - (x < y);
+}
+
+
+static int _bucket_of(const bst_key* splitters, int count, bst_key key)
+{
+    // the number of splitters less than or equal to key, so that equal
+    // keys always land in the same bucket.
+    int lo = 0;
+    int hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (splitters[mid] <= key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+
+typedef struct SortTask {
+    int thread;
+    int nthreads;
+    const bst_key* keys;
+    size_t n;
+    bst_key* buckets;    // scatter destination, bucket by bucket
+    bst_key* unique;     // final sorted and deduplicated keys
+    const bst_key* splitters;
+
+    // counts[t * nthreads + b] is the number of keys in thread t's chunk
+    // that belong to bucket b, and later the offset to scatter them to.
+    size_t* counts;
+    size_t* bucket_start;
+    size_t* unique_count;
+    pthread_barrier_t* barrier;
+} sort_task;
+
+
+static void* _sort_worker(void* arg)
+{
+    sort_task* task = arg;
+    int t = task->thread;
+    int nthreads = task->nthreads;
+    size_t lo = task->n * t / nthreads;
+    size_t hi = task->n * (t + 1) / nthreads;
+    size_t* counts = task->counts + (size_t) t * nthreads;
+
+    // count the keys of this thread's chunk going to each bucket
+    for (size_t i=lo; i<hi; i++)
+        counts[_bucket_of(task->splitters, nthreads - 1, task->keys[i])]++;
+
+    pthread_barrier_wait(task->barrier);
+
+    // the first thread turns the counts into scatter offsets
+    if (t == 0) {
+        size_t offset = 0;
+        for (int b=0; b<nthreads; b++) {
+            task->bucket_start[b] = offset;
+            for (int s=0; s<nthreads; s++) {
+                size_t count = task->counts[(size_t) s * nthreads + b];
+                task->counts[(size_t) s * nthreads + b] = offset;
+                offset += count;
+            }
+        }
+        task->bucket_start[nthreads] = offset;
+    }
+
+    pthread_barrier_wait(task->barrier);
+
+    for (size_t i=lo; i<hi; i++) {
+        bst_key key = task->keys[i];
+        task->buckets[counts[_bucket_of(task->splitters, nthreads - 1, key)]++] = key;
+    }
+
+    pthread_barrier_wait(task->barrier);
+
+    // sort and deduplicate this thread's bucket in place
+    bst_key* bucket = task->buckets + task->bucket_start[t];
+    size_t size = task->bucket_start[t + 1] - task->bucket_start[t];
+    qsort(bucket, size, sizeof(bst_key), _compare_keys);
+
+    size_t unique = 0;
+    for (size_t i=0; i<size; i++) {
+        if (i == 0 || bucket[i] != bucket[i - 1])
+            bucket[unique++] = bucket[i];
+    }
+    task->unique_count[t] = unique;
+
+    pthread_barrier_wait(task->barrier);
+
+    size_t offset = 0;
+    for (int b=0; b<t; b++)
+        offset += task->unique_count[b];
+
+    memcpy(task->unique + offset, bucket, unique * sizeof(bst_key));
+
+    return NULL;
+}
+
+
+static size_t _random_below(size_t n)
+{
+    // Two calls to rand() give 62 random bits (with glibc's RAND_MAX of
+    // 2^31 - 1), so every position of an input larger than RAND_MAX can be
+    // picked, and the bias of the modulo is negligible.
+    uint64_t bits = (uint64_t) rand() * ((uint64_t) RAND_MAX + 1) + (uint64_t) rand();
+    return (size_t) (bits % n);
+}
+
+
+static bst_key* _parallel_sort_unique(const bst_key* keys, size_t n, int nthreads, size_t* unique_n)
+{
+    // sample sort the keys into a new array, dropping duplicates
+    bst_key* unique = _parallel_malloc(sizeof(bst_key) * n);
+    bst_key* buckets = _parallel_malloc(sizeof(bst_key) * n);
+
+    int sample_count = nthreads * SAMPLES_PER_THREAD;
+    bst_key* samples = _parallel_malloc(sizeof(bst_key) * sample_count);
+    for (int i=0; i<sample_count; i++)
+        samples[i] = keys[_random_below(n)];
+    qsort(samples, sample_count, sizeof(bst_key), _compare_keys);
+
+    bst_key splitters[PARALLEL_MAX_THREADS];
+    for (int i=1; i<nthreads; i++)
+        splitters[i - 1] = samples[i * SAMPLES_PER_THREAD];
+
+    size_t* counts = _parallel_malloc(sizeof(size_t) * nthreads * nthreads);
+    memset(counts, 0, sizeof(size_t) * nthreads * nthreads);
+    size_t bucket_start[PARALLEL_MAX_THREADS + 1];
+    size_t unique_count[PARALLEL_MAX_THREADS];
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, nthreads);
+
+    sort_task tasks[PARALLEL_MAX_THREADS];
+    for (int t=0; t<nthreads; t++) {
+        tasks[t] = (sort_task) { t, nthreads, keys, n, buckets, unique, splitters,
+            counts, bucket_start, unique_count, &barrier };
+    }
+
+    _run_threads(nthreads, _sort_worker, tasks, sizeof(sort_task));
+
+    *unique_n = 0;
+    for (int t=0; t<nthreads; t++)
+        *unique_n += unique_count[t];
+
+    pthread_barrier_destroy(&barrier);
+    free(counts);
+    free(samples);
+    free(buckets);
+
+    return unique;
+}
+
+
+static int _built_height(size_t n)
+{
+    // the height of the tree _build_subtree makes from n keys
+    int height = 0;
+    for (; n; n >>= 1)
+        height++;
+
+    return height;
+}
+
+
+static bstnode* _build_subtree(const bst_key* keys, size_t n, bstnode* parent, int spawn_depth);
+
+
+typedef struct BuildTask {
+    const bst_key* keys;
+    size_t n;
+    bstnode* parent;
+    int spawn_depth;
+    bstnode* result;
+} build_task;
+
+
+static void* _build_worker(void* arg)
+{
+    build_task* task = arg;
+    task->result = _build_subtree(task->keys, task->n, task->parent, task->spawn_depth);
+
+    return NULL;
+}
+
+
+static bstnode* _build_subtree(const bst_key* keys, size_t n, bstnode* parent, int spawn_depth)
+{
+    // Builds the tree over the sorted keys with the median at the root. The
+    // left side gets the extra key when n is even, so the subtrees differ in
+    // height by at most one, with any extra height on the left. While
+    // spawn_depth is positive, the left subtree is built on another thread.
+    if (n == 0) return NULL;
+
+    size_t left_n = n / 2;
+    size_t right_n = n - left_n - 1;
+
+    bstnode* head = bstnode_create(keys[left_n]);
+    head->parent = parent;
+    head->rank = left_n + 1;
+    head->balance_factor = _built_height(right_n) - _built_height(left_n);
+
+    if (spawn_depth > 0) {
+        pthread_t thread;
+        build_task task = { keys, left_n, head, spawn_depth - 1, NULL };
+
+        if (pthread_create(&thread, NULL, _build_worker, &task)) {
+            fprintf(stderr, "ERROR in _build_subtree. Thread creation failed.\n");
+            exit(-1);
+        }
+
+        head->right = _build_subtree(keys + left_n + 1, right_n, head, spawn_depth - 1);
+        pthread_join(thread, NULL);
+        head->left = task.result;
+    } else {
+        head->left = _build_subtree(keys, left_n, head, 0);
+        head->right = _build_subtree(keys + left_n + 1, right_n, head, 0);
+    }
+
+    return head;
+}
+
+
+bst* avl_build_parallel(const bst_key* keys, size_t n, int nthreads)
+{
+    if (nthreads < 1) nthreads = 1;
+    if (nthreads > PARALLEL_MAX_THREADS) nthreads = PARALLEL_MAX_THREADS;
+
+    // very small inputs aren't worth splitting up
+    if (n < (size_t) nthreads * SAMPLES_PER_THREAD) nthreads = 1;
+
+    bst* tree = avl_create();
+    if (n == 0) {
+        return tree;
+    }
+
+    size_t unique_n;
+    bst_key* unique = _parallel_sort_unique(keys, n, nthreads, &unique_n);
+
+    // each level of spawning doubles the number of threads building
+    int spawn_depth = 0;
+    while ((1 << spawn_depth) < nthreads)
+        spawn_depth++;
+
+    tree->head = _build_subtree(unique, unique_n, NULL, spawn_depth);
+    tree->length = unique_n;
+    tree->height = _built_height(unique_n);
+    tree->leftmost = bst_node_min(tree->head);
+    tree->rightmost = bst_node_max(tree->head);
+
+    free(unique);
+    return tree;
+}
+
+
+void avl_execute_query(bst* tree, const tree_query* query, query_result* result)
+{
+    bst_size lo_rank, hi_rank;
+
+    switch (query->type) {
+        case QUERY_SEARCH:
+            result->node = bst_search(tree, query->arg);
+            break;
+        case QUERY_INDEX:
+            result->node = bst_index(tree, query->arg);
+            break;
+        case QUERY_GET_INDEX:
+            result->count = bst_get_index(tree, query->arg);
+            break;
+        case QUERY_RANGE_COUNT:
+            // the bound ranks are each one more than the number of keys
+            // before them.
+            bst_lower_bound(tree, query->arg, &lo_rank);
+            bst_upper_bound(tree, query->arg2, &hi_rank);
+            result->count = (query->arg2 >= query->arg) ? hi_rank - lo_rank : 0;
+            break;
+        default:
+            ASSERT_NOT_REACHED();
+    }
+}
+
+
+typedef struct QueryTask {
+    bst* tree;
+    const tree_query* queries;
+    query_result* results;
+    size_t n;
+    size_t* cursor;
+} query_task;
+
+
+static void* _query_worker(void* arg)
+{
+    query_task* task = arg;
+
+    while (1) {
+        size_t lo = __atomic_fetch_add(task->cursor, QUERY_CHUNK, __ATOMIC_RELAXED);
+        if (lo >= task->n) break;
+
+        size_t hi = (lo + QUERY_CHUNK < task->n) ? lo + QUERY_CHUNK : task->n;
+        for (size_t i=lo; i<hi; i++)
+            avl_execute_query(task->tree, &task->queries[i], &task->results[i]);
+    }
+
+    return NULL;
+}
+
+
+void avl_execute_queries(bst* tree, const tree_query* queries, size_t n,
+        query_result* results, int nthreads)
+{
+    // results[i] is the answer to queries[i]
+    if (nthreads < 1) nthreads = 1;
+    if (nthreads > PARALLEL_MAX_THREADS) nthreads = PARALLEL_MAX_THREADS;
+
+    size_t cursor = 0;
+    query_task tasks[PARALLEL_MAX_THREADS];
+    for (int t=0; t<nthreads; t++) {
+        tasks[t] = (query_task) { tree, queries, results, n, &cursor };
+    }
+
+    _run_threads(nthreads, _query_worker, tasks, sizeof(query_task));
+}
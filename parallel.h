@@ -0,0 +1,52 @@
+/*
+ * parallel.h
+ *
+ * Multi-threaded operations on AVL trees.
+ *
+ * avl_build_parallel builds a tree from an unsorted (and possibly duplicated)
+ * array of keys by sample sorting and deduplicating it in parallel, and then
+ * building the perfectly balanced tree over the result, with subtrees near the
+ * top built on separate threads. The ranks, parent pointers and balance factors
+ * are all set directly, so the result is an ordinary AVL tree.
+ *
+ * avl_execute_queries runs a large batch of mixed read-only queries against a
+ * tree that is no longer changing, using a pool of threads. Threads claim
+ * fixed-size chunks of the batch from a shared atomic cursor, so threads that
+ * finish their chunks early keep taking more rather than sitting idle. As the
+ * tree isn't modified, no locks are needed.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include "avl.h"
+
+// the largest number of threads any of these will use
+#define PARALLEL_MAX_THREADS 64
+
+// the number of queries claimed by a thread at a time
+#define QUERY_CHUNK 256
+
+#define QUERY_SEARCH 0       // node with key arg, or NULL
+#define QUERY_INDEX 1        // node at index arg, or NULL
+#define QUERY_GET_INDEX 2    // index of key arg, or -1
+#define QUERY_RANGE_COUNT 3  // number of keys in [arg, arg2]
+
+typedef struct TreeQuery {
+    int type;
+    bst_key arg;
+    bst_key arg2;
+} tree_query;
+
+typedef union QueryResult {
+    bstnode* node;
+    bst_size count;
+} query_result;
+
+bst* avl_build_parallel(const bst_key* keys, size_t n, int nthreads);
+
+void avl_execute_query(bst* tree, const tree_query* query, query_result* result);
+void avl_execute_queries(bst* tree, const tree_query* queries, size_t n,
+        query_result* results, int nthreads);
@@ -0,0 +1,163 @@
+/*
+ * pavl-test.c
+ * A simple test suite for the persistent AVL tree, checking that every
+ * version keeps its own contents (and stays balanced, with correct ranks)
+ * while later versions are built from it.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+
+#include "pavl.h"
+#include "bst-util.h"
+
+#define VERSIONS 200
+
+
+int check_pavl_node(pavlnode* head, int* count)
+{
+    // returns the height of the subtree, checking balance factors, ranks
+    // and ordering along the way. count is the number of nodes so far, in
+    // order.
+    if (head == NULL) return 0;
+
+    assert(head->refcount > 0);
+
+    int before = *count;
+    int left = check_pavl_node(head->left, count);
+    assert(head->rank == *count - before + 1);
+    (*count)++;
+    int right = check_pavl_node(head->right, count);
+
+    if (head->left) assert(head->left->value < head->value);
+    if (head->right) assert(head->right->value > head->value);
+    assert(head->balance_factor == right - left);
+    assert(abs(right - left) <= 1);
+
+    return 1 + MAX(left, right);
+}
+
+
+void check_version(pavl* version, char* contents, int range)
+{
+    int count = 0;
+    check_pavl_node(version->head, &count);
+    assert(count == version->length);
+
+    int index = 0;
+    for (int x=0; x<range; x++) {
+        if (contents[x]) {
+            index++;
+            assert(pavl_search(version, x)->value == x);
+            assert(pavl_get_index(version, x) == index);
+            assert(pavl_index(version, index)->value == x);
+        } else {
+            assert(!pavl_search(version, x));
+            assert(pavl_get_index(version, x) == -1);
+        }
+    }
+
+    assert(index == version->length);
+}
+
+
+int standard_tests()
+{
+    pavl* empty = pavl_create();
+    assert(empty->length == 0);
+    assert(!pavl_search(empty, 5));
+    assert(!pavl_index(empty, 1));
+
+    pavl* one = pavl_insert(empty, 5);
+    pavl* two = pavl_insert(one, 3);
+    pavl* dup = pavl_insert(two, 3);
+    assert(dup->head == two->head);
+
+    assert(empty->length == 0 && !empty->head);
+    assert(one->length == 1 && pavl_search(one, 5) && !pavl_search(one, 3));
+    assert(two->length == 2 && pavl_index(two, 1)->value == 3);
+
+    pavl* removed = pavl_delete(two, 5);
+    assert(removed->length == 1 && !pavl_search(removed, 5));
+    assert(pavl_search(two, 5));
+
+    pavl_release(empty);
+    pavl_release(one);
+    pavl_release(two);
+    pavl_release(dup);
+    pavl_release(removed);
+    assert(pavl_live_nodes() == 0);
+
+    printf("standard tests passed\n");
+    return 0;
+}
+
+
+int version_tests(int range)
+{
+    // Build a chain of versions by random inserts and deletes, keeping a
+    // copy of what each one should contain, and check that all of them are
+    // still intact at the end.
+    pavl* versions[VERSIONS];
+    char* contents[VERSIONS];
+
+    srand(time(NULL));
+    versions[0] = pavl_create();
+    contents[0] = calloc(range, 1);
+
+    for (int v=1; v<VERSIONS; v++) {
+        pavl* current = pavl_snapshot(versions[v-1]);
+        contents[v] = malloc(range);
+        memcpy(contents[v], contents[v-1], range);
+
+        for (int i=0; i<50; i++) {
+            int x = rand() % range;
+            pavl* next = (rand() % 3) ? pavl_insert(current, x) : pavl_delete(current, x);
+            contents[v][x] = (next->length > current->length) ||
+                (next->length == current->length && contents[v][x]);
+            pavl_release(current);
+            current = next;
+        }
+
+        versions[v] = current;
+    }
+
+    printf("Checking %d versions...\n", VERSIONS);
+    for (int v=0; v<VERSIONS; v++) {
+        check_version(versions[v], contents[v], range);
+    }
+
+    // release them out of order, checking the remaining versions are
+    // unaffected.
+    for (int v=0; v<VERSIONS; v+=2) {
+        pavl_release(versions[v]);
+        free(contents[v]);
+    }
+
+    for (int v=1; v<VERSIONS; v+=2) {
+        check_version(versions[v], contents[v], range);
+        pavl_release(versions[v]);
+        free(contents[v]);
+    }
+
+    assert(pavl_live_nodes() == 0);
+    printf("Passed\n");
+
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    standard_tests();
+    version_tests(2000);
+
+    return 0;
+}
@@ -0,0 +1,373 @@
+/*
+ * pavl.c
+ *
+ * A persistent (path-copying) AVL tree.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "pavl.h"
+
+// the number of nodes currently allocated, across all versions
+static long live_nodes = 0;
+
+
+static pavlnode* _pavl_node_create(int value)
+{
+    pavlnode* newnode = malloc(sizeof(pavlnode));
+    if (!newnode) {
+        fprintf(stderr, "MEMORY ERROR in _pavl_node_create. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    newnode->value = value;
+    newnode->rank = 1;
+    newnode->balance_factor = EVEN;
+    newnode->refcount = 1;
+    newnode->left = NULL;
+    newnode->right = NULL;
+
+    __atomic_add_fetch(&live_nodes, 1, __ATOMIC_RELAXED);
+    return newnode;
+}
+
+
+static pavlnode* _pavl_retain(pavlnode* head)
+{
+    if (head)
+        __atomic_add_fetch(&head->refcount, 1, __ATOMIC_RELAXED);
+
+    return head;
+}
+
+
+static void _pavl_release(pavlnode* head)
+{
+    if (!head || __atomic_sub_fetch(&head->refcount, 1, __ATOMIC_ACQ_REL))
+        return;
+
+    _pavl_release(head->left);
+    _pavl_release(head->right);
+    free(head);
+
+    __atomic_sub_fetch(&live_nodes, 1, __ATOMIC_RELAXED);
+}
+
+
+static pavlnode* _pavl_copy(pavlnode* original)
+{
+    // a private copy of original, sharing (and so retaining) its children
+    pavlnode* copy = _pavl_node_create(original->value);
+
+    copy->rank = original->rank;
+    copy->balance_factor = original->balance_factor;
+    copy->left = _pavl_retain(original->left);
+    copy->right = _pavl_retain(original->right);
+
+    return copy;
+}
+
+
+static pavlnode* _pavl_unique(pavlnode** slot)
+{
+    // Nodes reachable from another version can't be modified in place, so
+    // replace the node in slot (owned by a node that is itself private)
+    // with a private copy if it's shared.
+    if ((*slot)->refcount > 1) {
+        pavlnode* copy = _pavl_copy(*slot);
+        _pavl_release(*slot);
+        *slot = copy;
+    }
+
+    return *slot;
+}
+
+
+static pavlnode* _pavl_rotate(pavlnode* center, int direction)
+{
+    // Rotates center (which must be private) in direction, returning the
+    // new root of the subtree. Ranks are updated as in bst_rotate.
+    pavlnode* pivot = (direction == LEFT) ? _pavl_unique(&center->right) :
+        _pavl_unique(&center->left);
+
+    if (direction == LEFT) {
+        center->right = pivot->left;
+        pivot->left = center;
+        pivot->rank += center->rank;
+    } else {
+        center->left = pivot->right;
+        pivot->right = center;
+        center->rank -= pivot->rank;
+    }
+
+    return pivot;
+}
+
+
+static pavlnode* _pavl_rebalance(pavlnode* head, int direction)
+{
+    // head (private) is too heavy in direction. Rotate to fix it, and
+    // return the new root of the subtree. This mirrors avl_rebalance.
+    pavlnode* pivot = (direction == LEFT) ? _pavl_unique(&head->left) :
+        _pavl_unique(&head->right);
+
+    if (pivot->balance_factor == EVEN) {
+        // only possible after a delete
+        pavlnode* root = _pavl_rotate(head, REVERSE_DIRECTION(direction));
+        head->balance_factor = direction;
+        pivot->balance_factor = REVERSE_DIRECTION(direction);
+        return root;
+    }
+
+    if (pivot->balance_factor == direction) {
+        pavlnode* root = _pavl_rotate(head, REVERSE_DIRECTION(direction));
+        head->balance_factor = EVEN;
+        pivot->balance_factor = EVEN;
+        return root;
+    }
+
+    // double rotation
+    pavlnode* second_pivot = (direction == LEFT) ? _pavl_unique(&pivot->right) :
+        _pavl_unique(&pivot->left);
+    int second_balance = second_pivot->balance_factor;
+
+    if (direction == LEFT)
+        head->left = _pavl_rotate(pivot, LEFT);
+    else
+        head->right = _pavl_rotate(pivot, RIGHT);
+
+    pavlnode* root = _pavl_rotate(head, REVERSE_DIRECTION(direction));
+
+    head->balance_factor = (second_balance == direction) ? REVERSE_DIRECTION(direction) : EVEN;
+    pivot->balance_factor = (second_balance == REVERSE_DIRECTION(direction)) ? direction : EVEN;
+    second_pivot->balance_factor = EVEN;
+
+    return root;
+}
+
+
+static pavlnode* _pavl_insert(pavlnode* head, int value, int* grew)
+{
+    // Returns a new subtree containing value, built from copies of the
+    // nodes along the path to it. The value must not already be present.
+    if (!head) {
+        *grew = 1;
+        return _pavl_node_create(value);
+    }
+
+    pavlnode* copy = _pavl_copy(head);
+    int direction = (value < head->value) ? LEFT : RIGHT;
+
+    if (direction == LEFT) {
+        copy->rank++;
+        pavlnode* child = _pavl_insert(head->left, value, grew);
+        _pavl_release(copy->left);
+        copy->left = child;
+    } else {
+        pavlnode* child = _pavl_insert(head->right, value, grew);
+        _pavl_release(copy->right);
+        copy->right = child;
+    }
+
+    if (!*grew) {
+        return copy;
+    }
+
+    if (copy->balance_factor == REVERSE_DIRECTION(direction)) {
+        copy->balance_factor = EVEN;
+        *grew = 0;
+    } else if (copy->balance_factor == EVEN) {
+        copy->balance_factor = direction;
+    } else {
+        copy = _pavl_rebalance(copy, direction);
+        *grew = 0;
+    }
+
+    return copy;
+}
+
+
+static pavlnode* _pavl_delete_balancing(pavlnode* copy, int direction, int* shrunk)
+{
+    // the subtree on the direction side of copy has shrunk
+    if (copy->balance_factor == direction) {
+        copy->balance_factor = EVEN;
+    } else if (copy->balance_factor == EVEN) {
+        copy->balance_factor = REVERSE_DIRECTION(direction);
+        *shrunk = 0;
+    } else {
+        pavlnode* pivot = (direction == LEFT) ? copy->right : copy->left;
+        *shrunk = (pivot->balance_factor != EVEN);
+        copy = _pavl_rebalance(copy, REVERSE_DIRECTION(direction));
+    }
+
+    return copy;
+}
+
+
+static pavlnode* _pavl_delete(pavlnode* head, int value, int* shrunk)
+{
+    // Returns a new subtree without value, which must be present.
+    if (value == head->value && !(head->left && head->right)) {
+        *shrunk = 1;
+        return _pavl_retain((head->left) ? head->left : head->right);
+    }
+
+    pavlnode* copy = _pavl_copy(head);
+
+    if (value == head->value) {
+        // take on the value of the successor, and delete that instead.
+        pavlnode* successor = head->right;
+        while (successor->left)
+            successor = successor->left;
+
+        copy->value = successor->value;
+        value = successor->value;
+    }
+
+    if (value < copy->value) {
+        copy->rank--;
+        pavlnode* child = _pavl_delete(head->left, value, shrunk);
+        _pavl_release(copy->left);
+        copy->left = child;
+
+        if (*shrunk)
+            copy = _pavl_delete_balancing(copy, LEFT, shrunk);
+    } else {
+        pavlnode* child = _pavl_delete(head->right, value, shrunk);
+        _pavl_release(copy->right);
+        copy->right = child;
+
+        if (*shrunk)
+            copy = _pavl_delete_balancing(copy, RIGHT, shrunk);
+    }
+
+    return copy;
+}
+
+
+static pavl* _pavl_version(int length, pavlnode* head)
+{
+    pavl* version = malloc(sizeof(pavl));
+    if (!version) {
+        fprintf(stderr, "MEMORY ERROR in _pavl_version. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    version->length = length;
+    version->head = head;
+
+    return version;
+}
+
+
+pavl* pavl_create(void)
+{
+    return _pavl_version(0, NULL);
+}
+
+
+pavl* pavl_snapshot(pavl* version)
+{
+    // another handle on the same version, to be released separately
+    return _pavl_version(version->length, _pavl_retain(version->head));
+}
+
+
+void pavl_release(pavl* version)
+{
+    _pavl_release(version->head);
+    free(version);
+}
+
+
+pavl* pavl_insert(pavl* version, int value)
+{
+    // Returns a new version with value inserted. The original version is
+    // unchanged, and must still be released by the caller.
+    if (pavl_search(version, value)) {
+        return pavl_snapshot(version);
+    }
+
+    int grew = 0;
+    return _pavl_version(version->length + 1, _pavl_insert(version->head, value, &grew));
+}
+
+
+pavl* pavl_delete(pavl* version, int value)
+{
+    // Returns a new version with value removed. The original version is
+    // unchanged, and must still be released by the caller.
+    if (!pavl_search(version, value)) {
+        return pavl_snapshot(version);
+    }
+
+    int shrunk = 0;
+    return _pavl_version(version->length - 1, _pavl_delete(version->head, value, &shrunk));
+}
+
+
+pavlnode* pavl_search(pavl* version, int value)
+{
+    pavlnode* current = version->head;
+    while (current) {
+        if (current->value == value)
+            return current;
+
+        current = current->value > value ? current->left : current->right;
+    }
+
+    return NULL;
+}
+
+
+pavlnode* pavl_index(pavl* version, int index)
+{
+    if (index > version->length || index <= 0) return NULL;
+
+    pavlnode* current = version->head;
+    while (current) {
+        if (index == current->rank) return current;
+
+        if (index < current->rank) current = current->left;
+        else {
+            index = index - current->rank;
+            current = current->right;
+        }
+    }
+
+    return NULL;
+}
+
+
+int pavl_get_index(pavl* version, int value)
+{
+    pavlnode* current = version->head;
+    int index = 0;
+
+    while (current)  {
+        if (current->value == value) {
+            return index + current->rank;
+        }
+        if (value < current->value){
+            current = current->left;
+        }
+        else {
+            index += current->rank;
+            current = current->right;
+        }
+    }
+
+    return -1;
+}
+
+
+long pavl_live_nodes(void)
+{
+    return __atomic_load_n(&live_nodes, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,49 @@
+/*
+ * pavl.h
+ *
+ * A persistent (path-copying) AVL tree. Every insert or delete copies the
+ * O(lg n) nodes along its search path, leaving the original version intact,
+ * and returns a new version sharing all of its other nodes with the old one.
+ * A version can then be read (e.g., by analytic queries wanting a consistent
+ * point-in-time view) while writers keep producing new ones.
+ *
+ * Nodes are reference counted, with atomic updates, so versions may be
+ * released from any thread. A node is freed once no version (or node)
+ * refers to it. As nodes are shared between versions there are no parent
+ * pointers, so the rebalancing is done on the way back up a recursive
+ * descent instead.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include <assert.h>
+#include "bst.h"
+
+typedef struct PAVLNode {
+    int value;
+    int rank;
+    int balance_factor;
+    int refcount;
+    struct PAVLNode* left;
+    struct PAVLNode* right;
+} pavlnode;
+
+typedef struct PAVL {
+    int length;
+    pavlnode* head;
+} pavl;
+
+pavl* pavl_create(void);
+pavl* pavl_snapshot(pavl* version);
+void pavl_release(pavl* version);
+
+pavl* pavl_insert(pavl* version, int value);
+pavl* pavl_delete(pavl* version, int value);
+pavlnode* pavl_search(pavl* version, int value);
+pavlnode* pavl_index(pavl* version, int index);
+int pavl_get_index(pavl* version, int value);
+
+long pavl_live_nodes(void);
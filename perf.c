@@ -0,0 +1,152 @@
+/*
+ * perf.c
+ *
+ * Hardware performance counters for the benchmarks.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include "perf.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+const char* perf_event_names[PERF_EVENTS] = {
+    "cycles", "instr", "L1d-miss", "LLC-miss", "dTLB-miss", "br-miss"
+};
+
+
+#ifdef __linux__
+
+static const struct {
+    unsigned int type;
+    unsigned long long config;
+} _perf_events[PERF_EVENTS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+
+void perf_open(perf_counters* counters)
+{
+    counters->available = 0;
+    counters->error = 0;
+
+    for (int i=0; i<PERF_EVENTS; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = _perf_events[i].type;
+        attr.config = _perf_events[i].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        counters->fd[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        counters->values[i] = 0;
+        if (counters->fd[i] >= 0)
+            counters->available++;
+        else
+            counters->error = errno;
+    }
+}
+
+
+void perf_start(perf_counters* counters)
+{
+    for (int i=0; i<PERF_EVENTS; i++) {
+        if (counters->fd[i] < 0) continue;
+
+        ioctl(counters->fd[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(counters->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+
+void perf_stop(perf_counters* counters)
+{
+    for (int i=0; i<PERF_EVENTS; i++) {
+        if (counters->fd[i] < 0) continue;
+        ioctl(counters->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    for (int i=0; i<PERF_EVENTS; i++) {
+        if (counters->fd[i] < 0) continue;
+
+        // the count, the time enabled and the time actually counting
+        unsigned long long data[3];
+        if (read(counters->fd[i], data, sizeof(data)) != sizeof(data) || !data[2]) {
+            counters->values[i] = 0;
+            continue;
+        }
+
+        counters->values[i] = (data[2] < data[1]) ?
+            (unsigned long long) ((double) data[0] * data[1] / data[2]) : data[0];
+    }
+}
+
+
+void perf_close(perf_counters* counters)
+{
+    for (int i=0; i<PERF_EVENTS; i++) {
+        if (counters->fd[i] >= 0)
+            close(counters->fd[i]);
+        counters->fd[i] = -1;
+    }
+
+    counters->available = 0;
+}
+
+#else
+
+void perf_open(perf_counters* counters)
+{
+    for (int i=0; i<PERF_EVENTS; i++)
+        counters->fd[i] = -1;
+
+    counters->available = 0;
+    counters->error = ENOSYS;
+}
+
+
+void perf_start(perf_counters* counters) {}
+void perf_stop(perf_counters* counters) {}
+void perf_close(perf_counters* counters) {}
+
+#endif
+
+
+void perf_report(perf_counters* counters, int ops)
+{
+    // one line of per-operation counts, or nothing at all if there are no
+    // counters to report.
+    if (!counters->available || !ops) return;
+
+    printf("%19s", "");
+    for (int i=0; i<PERF_EVENTS; i++) {
+        if (counters->fd[i] < 0) continue;
+        printf(" %s %.1f", perf_event_names[i], (double) counters->values[i] / ops);
+    }
+
+    if (counters->fd[PERF_CYCLES] >= 0 && counters->fd[PERF_INSTRUCTIONS] >= 0
+            && counters->values[PERF_CYCLES])
+        printf(" IPC %.2f", (double) counters->values[PERF_INSTRUCTIONS] / counters->values[PERF_CYCLES]);
+
+    printf("\n");
+}
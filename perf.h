@@ -0,0 +1,44 @@
+/*
+ * perf.h
+ *
+ * Hardware performance counters for the benchmarks, through perf_event_open.
+ * Each event is opened as its own counter, counting user space only for the
+ * calling thread, and scaled by the fraction of the time it was actually
+ * scheduled on the PMU if the kernel had to multiplex them.
+ *
+ * Counters that can't be opened (no PMU access in a container, a paranoid
+ * kernel setting, a CPU without the event, or a platform other than Linux)
+ * are simply left out of the report.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#define PERF_CYCLES 0
+#define PERF_INSTRUCTIONS 1
+#define PERF_L1D_MISSES 2
+#define PERF_LLC_MISSES 3
+#define PERF_DTLB_MISSES 4
+#define PERF_BRANCH_MISSES 5
+#define PERF_EVENTS 6
+
+typedef struct PerfCounters {
+    int fd[PERF_EVENTS];
+    unsigned long long values[PERF_EVENTS];
+
+    // the number of counters that could be opened, and the errno from the
+    // last one that couldn't
+    int available;
+    int error;
+} perf_counters;
+
+extern const char* perf_event_names[PERF_EVENTS];
+
+void perf_open(perf_counters* counters);
+void perf_start(perf_counters* counters);
+void perf_stop(perf_counters* counters);
+void perf_close(perf_counters* counters);
+
+void perf_report(perf_counters* counters, int ops);
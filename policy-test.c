@@ -0,0 +1,210 @@
+/*
+ * policy-test.c
+ * A test suite run against each of the balancing policies, verifying both the
+ * shared bst properties (ordering, ranks, parent links) and the invariants of
+ * the individual balancing schemes.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+
+#include "policy.h"
+#include "rb.h"
+#include "wavl.h"
+#include "treap.h"
+#include "hash.h"
+#include "bst-util.h"
+
+
+int check_rb_properties(bstnode* head)
+{
+    // returns the black height of the subtree
+    if (head == NULL) return 1;
+
+    if (RB_IS_RED(head)) {
+        assert(!RB_IS_RED(head->left));
+        assert(!RB_IS_RED(head->right));
+    }
+
+    int left = check_rb_properties(head->left);
+    int right = check_rb_properties(head->right);
+    assert(left == right);
+
+    return left + (RB_IS_RED(head) ? 0 : 1);
+}
+
+
+void check_wavl_ranks(bstnode* head)
+{
+    if (head == NULL) return;
+
+    int left_diff = WAVL_RANK(head) - WAVL_RANK(head->left);
+    int right_diff = WAVL_RANK(head) - WAVL_RANK(head->right);
+
+    assert(left_diff == 1 || left_diff == 2);
+    assert(right_diff == 1 || right_diff == 2);
+
+    if (!head->left && !head->right)
+        assert(WAVL_RANK(head) == 0);
+
+    check_wavl_ranks(head->left);
+    check_wavl_ranks(head->right);
+}
+
+
+void check_heap_order(bstnode* head)
+{
+    if (head == NULL) return;
+
+    if (head->left)
+        assert(TREAP_PRIORITY(head->left) <= TREAP_PRIORITY(head));
+    if (head->right)
+        assert(TREAP_PRIORITY(head->right) <= TREAP_PRIORITY(head));
+
+    check_heap_order(head->left);
+    check_heap_order(head->right);
+}
+
+
+void check_policy_invariants(const balance_policy* policy, bst* tree)
+{
+    check_bst_ordering(tree);
+    check_parent_links(tree->head);
+    check_extremes(tree);
+    assert(check_subtree_ranks(tree->head) == tree->length);
+
+    if (policy == &avl_policy) {
+        check_balance_factors(tree->head);
+        check_strict_balance(tree->head, 0);
+    } else if (policy == &rb_policy) {
+        assert(!RB_IS_RED(tree->head));
+        check_rb_properties(tree->head);
+    } else if (policy == &wavl_policy) {
+        check_wavl_ranks(tree->head);
+    } else if (policy == &treap_policy) {
+        check_heap_order(tree->head);
+    }
+}
+
+
+int standard_tests(const balance_policy* policy)
+{
+    printf("Testing %s...\n", policy->name);
+
+    bst* tree = policy->create();
+    assert(!tree->head);
+    assert(tree->length == 0);
+    assert(policy->search(tree, 8) == NULL);
+    assert(policy->index(tree, 1) == NULL);
+    assert(policy->delete(tree, 8) == 0);
+
+    int values[] = {5, 6, 1, 0, 15, 48, 31, 25, 41, 43, 36, 7, 95, 85};
+    int count = sizeof(values) / sizeof(values[0]);
+
+    for (int i=0; i<count; i++) {
+        assert(policy->insert(tree, values[i]) == 1);
+        check_policy_invariants(policy, tree);
+    }
+
+    assert(tree->length == count);
+    assert(policy->insert(tree, 5) == 0);
+    assert(tree->length == count);
+
+    assert(policy->index(tree, 1)->value == 0);
+    assert(policy->index(tree, 2)->value == 1);
+    assert(policy->index(tree, count)->value == 95);
+    assert(policy->get_index(tree, 0) == 1);
+    assert(policy->get_index(tree, 95) == count);
+    assert(policy->get_index(tree, 1000) == -1);
+    printf("\tinsert and index passed\n");
+
+    for (int i=0; i<count; i++) {
+        assert(policy->search(tree, values[i])->value == values[i]);
+        int idx = policy->get_index(tree, values[i]);
+        assert(policy->index(tree, idx)->value == values[i]);
+    }
+    assert(policy->search(tree, 20) == NULL);
+    printf("\tsearch and get_index passed\n");
+
+    for (int i=0; i<count; i++) {
+        assert(policy->delete(tree, values[i]) == 1);
+        assert(policy->delete(tree, values[i]) == 0);
+        assert(policy->search(tree, values[i]) == NULL);
+        assert(tree->length == count - i - 1);
+        check_policy_invariants(policy, tree);
+    }
+    assert(!tree->head);
+    printf("\tdelete passed\n");
+
+    policy->clear_destroy(tree);
+    return 0;
+}
+
+
+void check_hash_index(bst* tree)
+{
+    // every node is indexed, and nothing else is
+    assert(tree->hash->count == (size_t) tree->length);
+    for (bstnode* node = bst_node_min(tree->head); node; node = bst_node_next(node))
+        assert(bst_hash_get(tree->hash, node->value) == node);
+}
+
+
+int random_stress(const balance_policy* policy, int n, int rounds, int hashed)
+{
+    printf("Random insert/delete stress for %s%s...\n", policy->name,
+            (hashed) ? " (hashed)" : "");
+    bst* tree = policy->create();
+    if (hashed)
+        tree->hash = bst_hash_create(0);
+
+    srand(time(NULL));
+    for (int r=0; r<rounds; r++) {
+        for (int i=0; i<n; i++) {
+            int x = rand() % (4 * n);
+            int present = tree->length;
+            int rc = policy->insert(tree, x);
+            assert(tree->length == present + rc);
+        }
+        check_policy_invariants(policy, tree);
+        check_bst_indexing(tree);
+        if (hashed) check_hash_index(tree);
+
+        for (int i=0; i<n; i++) {
+            int x = rand() % (4 * n);
+            int present = tree->length;
+            int rc = policy->delete(tree, x);
+            assert(tree->length == present - rc);
+            assert(policy->search(tree, x) == NULL);
+        }
+        check_policy_invariants(policy, tree);
+        check_bst_indexing(tree);
+        if (hashed) check_hash_index(tree);
+    }
+
+    printf("\tpassed\n");
+    policy->clear_destroy(tree);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    for (int i=0; balance_policies[i]; i++) {
+        if (argc > 1 && strcmp(argv[1], balance_policies[i]->name))
+            continue;
+
+        standard_tests(balance_policies[i]);
+        random_stress(balance_policies[i], 500, 20, 0);
+        random_stress(balance_policies[i], 500, 20, 1);
+    }
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * policy.c
+ *
+ * A common interface over the balancing schemes that share the bst node and
+ * tree objects.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <string.h>
+#include "policy.h"
+#include "avl.h"
+#include "rb.h"
+#include "wavl.h"
+#include "treap.h"
+#include "splay.h"
+
+
+const balance_policy avl_policy = {
+    "avl", avl_create, avl_insert, avl_delete, avl_search, avl_index,
+    avl_get_index, avl_clear_destroy
+};
+
+const balance_policy rb_policy = {
+    "rb", rb_create, rb_insert, rb_delete, rb_search, rb_index,
+    rb_get_index, bst_clear_destroy
+};
+
+const balance_policy wavl_policy = {
+    "wavl", wavl_create, wavl_insert, wavl_delete, wavl_search, wavl_index,
+    wavl_get_index, bst_clear_destroy
+};
+
+const balance_policy treap_policy = {
+    "treap", treap_create, treap_insert, treap_delete, treap_search,
+    treap_index, treap_get_index, bst_clear_destroy
+};
+
+const balance_policy splay_policy = {
+    "splay", splay_create, splay_insert, splay_delete, splay_search,
+    splay_index, splay_get_index, bst_clear_destroy
+};
+
+
+const balance_policy* balance_policies[] = {
+    &avl_policy, &rb_policy, &wavl_policy, &treap_policy, &splay_policy, NULL
+};
+
+
+const balance_policy* balance_policy_find(const char* name)
+{
+    for (int i=0; balance_policies[i]; i++) {
+        if (!strcmp(balance_policies[i]->name, name))
+            return balance_policies[i];
+    }
+
+    return NULL;
+}
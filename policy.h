@@ -0,0 +1,37 @@
+/*
+ * policy.h
+ *
+ * A common interface over the balancing schemes that share the bst node and
+ * tree objects, so that the scheme backing a tree can be chosen at run time
+ * (e.g., from benchmark results for a given workload).
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include "bst.h"
+
+typedef struct BalancePolicy {
+    const char* name;
+
+    bst* (*create)(void);
+    int (*insert)(bst* tree, bst_key value);
+    int (*delete)(bst* tree, bst_key value);
+    bstnode* (*search)(bst* tree, bst_key value);
+    bstnode* (*index)(bst* tree, bst_size index);
+    bst_size (*get_index)(bst* tree, bst_key value);
+    void (*clear_destroy)(bst* tree);
+} balance_policy;
+
+extern const balance_policy avl_policy;
+extern const balance_policy rb_policy;
+extern const balance_policy wavl_policy;
+extern const balance_policy treap_policy;
+extern const balance_policy splay_policy;
+
+// NULL terminated list of all of the available policies
+extern const balance_policy* balance_policies[];
+
+const balance_policy* balance_policy_find(const char* name);
@@ -0,0 +1,204 @@
+/*
+ * quantile-test.c
+ * A simple test suite for the sliding-window quantiles, checking every
+ * answer against a sorted copy of the window, for a few window sizes and
+ * ranges of samples (the small ones having many duplicates).
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+#include <math.h>
+
+#include "quantile.h"
+#include "bst-util.h"
+
+
+static int compare_ints(const void* a, const void* b)
+{
+    int x = *(const int*) a;
+    int y = *(const int*) b;
+
+    return (x > y) - (x < y);
+}
+
+
+void check_tree(quantile_window* window)
+{
+    bst* tree = window->tree;
+
+    check_bst_ordering(tree);
+    check_parent_links(tree->head);
+    check_extremes(tree);
+    assert(check_subtree_ranks(tree->head) == tree->length);
+    assert(check_balance_factors(tree->head) == tree->height);
+    check_strict_balance(tree->head, 0);
+
+    // the counts account for exactly the samples in the window
+    assert(bst_subtree_aggregate(tree, tree->head, 0) == window->count);
+    for (bstnode* node = bst_node_min(tree->head); node; node = bst_node_next(node))
+        assert(BST_PAYLOAD(node) > 0);
+}
+
+
+void check_quantiles(quantile_window* window, const int* recent, int count)
+{
+    // the quantiles in thousandths, so that the expected ranks are exact
+    static const int permille[] = {990, 0, 500, 250, 1000, 900, 1, 500, 750, 70};
+    int k = sizeof(permille) / sizeof(permille[0]);
+
+    int* sorted = malloc(sizeof(int) * count);
+    memcpy(sorted, recent, sizeof(int) * count);
+    qsort(sorted, count, sizeof(int), compare_ints);
+
+    double qs[sizeof(permille) / sizeof(permille[0])];
+    for (int i=0; i<k; i++)
+        qs[i] = permille[i] / 1000.0;
+
+    int out[sizeof(permille) / sizeof(permille[0])];
+    assert(quantile_get_many(window, qs, k, out));
+
+    for (int i=0; i<k; i++) {
+        int rank = (permille[i] * count + 999) / 1000;
+        if (rank < 1) rank = 1;
+
+        int value;
+        assert(quantile_get(window, qs[i], &value));
+        assert(value == sorted[rank - 1]);
+        assert(out[i] == sorted[rank - 1]);
+    }
+
+    free(sorted);
+}
+
+
+int standard_tests()
+{
+    quantile_window* window = quantile_create(4);
+    int value;
+
+    printf("Standard quantile tests\n");
+
+    assert(!quantile_get(window, 0.5, &value));
+
+    quantile_push(window, 7);
+    assert(quantile_get(window, 0, &value) && value == 7);
+    assert(quantile_get(window, 1, &value) && value == 7);
+
+    quantile_push(window, 3);
+    quantile_push(window, 7);
+    quantile_push(window, 5);
+    assert(window->tree->length == 3);
+    assert(quantile_get(window, 0.5, &value) && value == 5);
+    assert(quantile_get(window, 0.75, &value) && value == 7);
+
+    // the first 7 falls out, but the second is still in the window
+    quantile_push(window, 1);
+    assert(window->tree->length == 4);
+    assert(quantile_get(window, 1, &value) && value == 7);
+    assert(quantile_get(window, 0.25, &value) && value == 1);
+
+    // and then the 3, and the second 7
+    quantile_push(window, 1);
+    quantile_push(window, 1);
+    assert(window->tree->length == 2);
+    assert(quantile_get(window, 0.75, &value) && value == 1);
+    assert(quantile_get(window, 1, &value) && value == 5);
+
+    check_tree(window);
+    quantile_destroy(window);
+
+    // q * n that rounds to just above a whole number keeps its rank:
+    // 0.07 * 100 is 7.000000000000001 in doubles, but the 0.07 quantile of
+    // 1 to 100 is still the 7th
+    window = quantile_create(100);
+    for (int i=100; i>0; i--)
+        quantile_push(window, i);
+    assert(quantile_get(window, 0.07, &value) && value == 7);
+    assert(quantile_get(window, 0.14, &value) && value == 14);
+    assert(quantile_get(window, 0.56, &value) && value == 56);
+    assert(quantile_get(window, 0.071, &value) && value == 8);
+
+    printf("\tpassed\n");
+    quantile_destroy(window);
+    return 0;
+}
+
+
+int random_tests(int size, int range, int steps)
+{
+    printf("Random quantile tests (window %d, samples below %d)\n", size, range);
+
+    quantile_window* window = quantile_create(size);
+    int* samples = malloc(sizeof(int) * steps);
+
+    for (int i=0; i<steps; i++) {
+        samples[i] = rand() % range - range / 2;
+        quantile_push(window, samples[i]);
+
+        int count = (i + 1 < size) ? i + 1 : size;
+        assert(window->count == count);
+
+        if (i % (steps / 50) == 0 || i < 2 * size) {
+            check_quantiles(window, samples + i + 1 - count, count);
+        }
+
+        if (i % (steps / 10) == 0)
+            check_tree(window);
+    }
+
+    check_tree(window);
+
+    printf("\tpassed\n");
+    free(samples);
+    quantile_destroy(window);
+    return 0;
+}
+
+
+int rank_tests(int trials)
+{
+    printf("Nearest rank tests\n");
+
+    // windows where the rounding in q * n outgrows a fixed tolerance
+    assert(quantile_rank(0.07, 100) == 7);
+    assert(quantile_rank(0.556, 38452500) == 21379590);
+    assert(quantile_rank(0, 38452500) == 1);
+    assert(quantile_rank(1, 38452500) == 38452500);
+
+    // every quantile in thousandths, against integer arithmetic, for
+    // windows of up to 2^31 - 1 samples
+    for (int i=0; i<trials; i++) {
+        long long n = ((long long) rand() * (RAND_MAX + 1ll) + rand()) % 2147483647 + 1;
+        for (int permille=0; permille<=1000; permille++) {
+            long long expected = (permille * n + 999) / 1000;
+            if (expected < 1) expected = 1;
+            assert(quantile_rank(permille / 1000.0, n) == expected);
+        }
+    }
+
+    printf("\tpassed\n");
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    srand(time(NULL));
+    standard_tests();
+    rank_tests(20000);
+
+    random_tests(1, 10, 1000);
+    random_tests(16, 4, 10000);
+    random_tests(100, 50, 20000);
+    random_tests(1000, 1000000, 20000);
+    random_tests(5000, 100, 50000);
+
+    return 0;
+}
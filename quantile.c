@@ -0,0 +1,162 @@
+/*
+ * quantile.c
+ *
+ * Streaming quantiles over a sliding window.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include "quantile.h"
+
+#define SAMPLE_COUNT 0
+
+
+quantile_window* quantile_create(int window)
+{
+    static const bst_monoid sample_count[] = { BST_MONOID_SUM(bst_lift_payload) };
+
+    assert(window > 0);
+
+    quantile_window* w = malloc(sizeof(quantile_window));
+    if (!w) {
+        fprintf(stderr, "MEMORY ERROR in quantile_create. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    w->ring = malloc(sizeof(int) * window);
+    if (!w->ring) {
+        fprintf(stderr, "MEMORY ERROR in quantile_create. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    w->tree = avl_create_augmented(sample_count, 1);
+    w->capacity = window;
+    w->count = 0;
+    w->oldest = 0;
+
+    return w;
+}
+
+
+void quantile_push(quantile_window* window, int sample)
+{
+    // the new sample takes the oldest one's slot, once the window is full
+    int slot = (window->oldest + window->count) % window->capacity;
+
+    if (window->count == window->capacity) {
+        int evicted = window->ring[slot];
+        bstnode* node = avl_search(window->tree, evicted);
+
+        if (BST_PAYLOAD(node) > 1)
+            bst_set_payload(window->tree, node, BST_PAYLOAD(node) - 1);
+        else
+            avl_delete(window->tree, evicted);
+
+        window->oldest = (window->oldest + 1) % window->capacity;
+    } else {
+        window->count++;
+    }
+
+    window->ring[slot] = sample;
+
+    bstnode* node = avl_search(window->tree, sample);
+    if (node)
+        bst_set_payload(window->tree, node, BST_PAYLOAD(node) + 1);
+    else
+        avl_insert_payload(window->tree, sample, 1);
+}
+
+
+typedef struct QuantileQuery {
+    long long rank;
+    int position;
+} quantile_query;
+
+
+static void _select_by_count(bst* tree, bstnode* head, long long offset,
+        quantile_query* queries, int lo, int hi, int* out)
+{
+    // Finds the sample at each of the (sorted) ranks in queries[lo, hi)
+    // within this subtree, whose samples come after the first offset. The
+    // queries are split around this node's copies, and each side descends
+    // once for all of its queries.
+    if (lo >= hi) return;
+
+    long long left = offset + bst_subtree_aggregate(tree, head->left, SAMPLE_COUNT);
+    long long mine = left + BST_PAYLOAD(head);
+
+    int split_lo = lo;
+    while (split_lo < hi && queries[split_lo].rank <= left)
+        split_lo++;
+
+    int split_hi = split_lo;
+    while (split_hi < hi && queries[split_hi].rank <= mine)
+        out[queries[split_hi++].position] = head->value;
+
+    _select_by_count(tree, head->left, offset, queries, lo, split_lo, out);
+    _select_by_count(tree, head->right, mine, queries, split_hi, hi, out);
+}
+
+
+long long quantile_rank(double q, long long n)
+{
+    // The nearest rank of the q quantile of n samples. q * n can land just
+    // above a whole number (0.07 * 100 is 7.000000000000001), which ceil
+    // would round up to the next rank. The error in q and in the product
+    // is relative, a few units in the last place, so the product is pulled
+    // down by a little more than that before rounding up; anything closer
+    // to the whole number than this is indistinguishable from it in q.
+    long long rank = (long long) ceil(q * n * (1 - 4 * DBL_EPSILON));
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+
+    return rank;
+}
+
+
+int quantile_get_many(quantile_window* window, const double* qs, int k, int* out)
+{
+    // Sets out[i] to the qs[i] quantile of the window. Returns 0, leaving
+    // out alone, if the window is empty.
+    assert(k <= QUANTILE_MAX_QUERIES);
+
+    if (!window->count) return 0;
+
+    // the nearest ranks, insertion sorted (as there are only a few)
+    quantile_query queries[QUANTILE_MAX_QUERIES];
+    for (int i=0; i<k; i++) {
+        long long rank = quantile_rank(qs[i], window->count);
+
+        int j = i;
+        while (j > 0 && queries[j - 1].rank > rank) {
+            queries[j] = queries[j - 1];
+            j--;
+        }
+
+        queries[j].rank = rank;
+        queries[j].position = i;
+    }
+
+    _select_by_count(window->tree, window->tree->head, 0, queries, 0, k, out);
+    return 1;
+}
+
+
+int quantile_get(quantile_window* window, double q, int* value)
+{
+    return quantile_get_many(window, &q, 1, value);
+}
+
+
+void quantile_destroy(quantile_window* window)
+{
+    avl_clear_destroy(window->tree);
+    free(window->ring);
+    free(window);
+}
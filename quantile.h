@@ -0,0 +1,50 @@
+/*
+ * quantile.h
+ *
+ * Streaming quantiles over a sliding window of the most recent samples. The
+ * window is kept both in arrival order, in a ring buffer, and in sorted order,
+ * in an augmented AVL tree with one node per distinct sample. Each node's
+ * payload is the number of copies of its sample in the window, and each
+ * subtree carries the sum of these, so the tree can be descended by sample
+ * count rather than by node count.
+ *
+ * Each step is one insert (or count increment) for the new sample and one
+ * delete (or decrement) for the one falling out of the window, both O(lg n).
+ * Any set of quantiles is then answered by descents that share the nodes
+ * they have in common, so asking for p50, p90 and p99 together costs little
+ * more than asking for one.
+ *
+ * Quantiles use the nearest-rank definition: the q quantile of n samples is
+ * the ceil(q * n)th smallest (and the smallest for q = 0), as given by
+ * quantile_rank, which doesn't let rounding in q * n move it up a rank.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include "avl.h"
+
+// the most quantiles quantile_get_many answers at once
+#define QUANTILE_MAX_QUERIES 64
+
+typedef struct QuantileWindow {
+    // one node per distinct sample, with its count as payload
+    bst* tree;
+
+    // the samples in arrival order, the oldest at ring[oldest]
+    int* ring;
+    int capacity;
+    int count;
+    int oldest;
+} quantile_window;
+
+quantile_window* quantile_create(int window);
+
+void quantile_push(quantile_window* window, int sample);
+int quantile_get(quantile_window* window, double q, int* value);
+int quantile_get_many(quantile_window* window, const double* qs, int k, int* out);
+long long quantile_rank(double q, long long n);
+
+void quantile_destroy(quantile_window* window);
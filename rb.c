@@ -0,0 +1,180 @@
+/*
+ * rb.c
+ *
+ * An implementation of the Red-Black Balanced Binary Search Tree
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "rb.h"
+
+
+bst* rb_create(void)
+{
+    return bst_create();
+}
+
+
+static void _rb_insert_fixup(bst* tree, bstnode* current)
+{
+    // The root is always black, so a red parent always has a parent of its
+    // own.
+    while (RB_IS_RED(current->parent)) {
+        bstnode* parent = current->parent;
+        bstnode* grandparent = parent->parent;
+        int side = (grandparent->left == parent) ? LEFT : RIGHT;
+        bstnode* uncle = BRANCH(REVERSE_DIRECTION(side), grandparent);
+
+        if (RB_IS_RED(uncle)) {
+            // push the blackness of the grandparent down a level, and
+            // continue fixing things from there.
+            parent->balance_factor = RB_BLACK;
+            uncle->balance_factor = RB_BLACK;
+            grandparent->balance_factor = RB_RED;
+            current = grandparent;
+            continue;
+        }
+
+        if (BRANCH(REVERSE_DIRECTION(side), parent) == current) {
+            // inner grandchild, so rotate it to the outside first
+            bst_rotate(tree, parent, side);
+            current = parent;
+            parent = current->parent;
+        }
+
+        parent->balance_factor = RB_BLACK;
+        grandparent->balance_factor = RB_RED;
+        bst_rotate(tree, grandparent, REVERSE_DIRECTION(side));
+    }
+
+    tree->head->balance_factor = RB_BLACK;
+}
+
+
+int rb_insert(bst* tree, bst_key value)
+{
+    bstnode* newnode = bst_create_node(tree, value);
+    newnode->balance_factor = RB_RED;
+
+    if (tree->length == 0) {
+        newnode->balance_factor = RB_BLACK;
+        bst_node_insert(tree, newnode, NULL);
+        return 1;
+    }
+
+    node* path_tracker = init_update_tracker();
+    bstnode* insert_location = bst_find_node_and_path(tree, value, &path_tracker, 1);
+
+    if (insert_location) {
+        revert_rank_updates(path_tracker, -1);
+        destroy_update_tracker(path_tracker);
+        free(newnode);
+        return 0;
+    }
+
+    bst_node_insert(tree, newnode, path_tracker);
+    destroy_update_tracker(path_tracker);
+
+    _rb_insert_fixup(tree, newnode);
+
+    return 1;
+}
+
+
+static void _rb_delete_fixup(bst* tree, bstnode* parent, int direction)
+{
+    // current carries an "extra" black that needs to be either absorbed by
+    // recoloring, or pushed up the tree.
+    bstnode* current = (parent) ? BRANCH(direction, parent) : tree->head;
+
+    while (parent && !RB_IS_RED(current)) {
+        bstnode* sibling = BRANCH(REVERSE_DIRECTION(direction), parent);
+
+        if (RB_IS_RED(sibling)) {
+            sibling->balance_factor = RB_BLACK;
+            parent->balance_factor = RB_RED;
+            bst_rotate(tree, parent, direction);
+            sibling = BRANCH(REVERSE_DIRECTION(direction), parent);
+        }
+
+        bstnode* near = BRANCH(direction, sibling);
+        bstnode* far = BRANCH(REVERSE_DIRECTION(direction), sibling);
+
+        if (!RB_IS_RED(near) && !RB_IS_RED(far)) {
+            sibling->balance_factor = RB_RED;
+            current = parent;
+            parent = current->parent;
+            if (parent)
+                direction = (parent->left == current) ? LEFT : RIGHT;
+            continue;
+        }
+
+        if (!RB_IS_RED(far)) {
+            near->balance_factor = RB_BLACK;
+            sibling->balance_factor = RB_RED;
+            bst_rotate(tree, sibling, REVERSE_DIRECTION(direction));
+            far = sibling;
+            sibling = BRANCH(REVERSE_DIRECTION(direction), parent);
+        }
+
+        sibling->balance_factor = parent->balance_factor;
+        parent->balance_factor = RB_BLACK;
+        far->balance_factor = RB_BLACK;
+        bst_rotate(tree, parent, direction);
+
+        current = tree->head;
+        break;
+    }
+
+    if (current)
+        current->balance_factor = RB_BLACK;
+}
+
+
+int rb_delete(bst* tree, bst_key value)
+{
+    bstnode* todelete = bst_search(tree, value);
+
+    if (!todelete) {
+        return 0;
+    }
+
+    // The color that actually leaves the tree is that of the node removed
+    // from its position, which is the successor if todelete has two
+    // children (the successor takes on todelete's color when it moves).
+    bstnode* removed = (todelete->left && todelete->right) ?
+        bst_node_min(todelete->right) : todelete;
+    int removed_color = removed->balance_factor;
+
+    int direction;
+    bstnode* parent = bst_node_unlink(tree, todelete, &direction);
+    bst_free_node(tree, todelete);
+
+    if (removed_color == RB_BLACK) {
+        _rb_delete_fixup(tree, parent, direction);
+    }
+
+    return 1;
+}
+
+
+bstnode* rb_search(bst* tree, bst_key value)
+{
+    return bst_search(tree, value);
+}
+
+
+bstnode* rb_index(bst* tree, bst_size index)
+{
+    return bst_index(tree, index);
+}
+
+
+bst_size rb_get_index(bst* tree, bst_key value)
+{
+    return bst_get_index(tree, value);
+}
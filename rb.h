@@ -0,0 +1,31 @@
+/*
+ * rb.h
+ *
+ * An implementation of the Red-Black Balanced Binary Search Tree, built on
+ * the same node and tree objects (and rank-maintaining rotations) as the bst
+ * and avl modules. The color of each node is stored in its balance_factor
+ * field.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include "nodes.h"
+#include <assert.h>
+#include "bst.h"
+#include "tracker.h"
+
+#define RB_BLACK 0
+#define RB_RED   1
+
+#define RB_IS_RED(node) ((node) && (node)->balance_factor == RB_RED)
+
+bst* rb_create(void);
+
+int rb_insert(bst* tree, bst_key value);
+int rb_delete(bst* tree, bst_key value);
+bstnode* rb_search(bst* tree, bst_key value);
+bstnode* rb_index(bst* tree, bst_size index);
+bst_size rb_get_index(bst* tree, bst_key value);
@@ -0,0 +1,178 @@
+/*
+ * savl-test.c
+ * A simple test suite for the AVL tree without parent pointers, checking the
+ * balance factors, ranks and ordering after random inserts and deletes (by
+ * key, by rank and from either end).
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+
+#include "savl.h"
+#include "bst-util.h"
+
+
+int check_savl_node(savlnode* head, int* count)
+{
+    // returns the height of the subtree, checking balance factors, ranks
+    // and ordering along the way. count is the number of nodes so far, in
+    // order.
+    if (head == NULL) return 0;
+
+    int before = *count;
+    int left = check_savl_node(head->left, count);
+    assert(head->rank == *count - before + 1);
+    (*count)++;
+    int right = check_savl_node(head->right, count);
+
+    if (head->left) assert(head->left->value < head->value);
+    if (head->right) assert(head->right->value > head->value);
+    assert(head->balance_factor == right - left);
+    assert(abs(right - left) <= 1);
+
+    return 1 + MAX(left, right);
+}
+
+
+void check_tree(savl* tree, char* contents, int range)
+{
+    int count = 0;
+    assert(check_savl_node(tree->head, &count) == tree->height);
+    assert(count == tree->length);
+
+    int index = 0;
+    savlnode* previous = NULL;
+    for (int x=0; x<range; x++) {
+        int rank;
+        savlnode* bound = savl_lower_bound(tree, x, &rank);
+
+        if (contents[x]) {
+            index++;
+            assert(savl_search(tree, x)->value == x);
+            assert(savl_get_index(tree, x) == index);
+            assert(savl_index(tree, index)->value == x);
+            assert(bound->value == x && rank == index);
+
+            assert(savl_prev(tree, bound) == previous);
+            if (previous) assert(savl_next(tree, previous) == bound);
+            previous = bound;
+        } else {
+            assert(!savl_search(tree, x));
+            assert(savl_get_index(tree, x) == -1);
+            assert(rank == index + 1);
+            assert(!bound || bound->value > x);
+        }
+    }
+
+    assert(index == tree->length);
+    assert(!savl_index(tree, 0) && !savl_index(tree, index + 1));
+    if (previous) {
+        assert(!savl_next(tree, previous));
+        assert(savl_peek_max(tree) == previous);
+    }
+}
+
+
+int standard_tests()
+{
+    savl* tree = savl_create();
+    int value;
+
+    assert(tree->length == 0 && tree->height == 0);
+    assert(!savl_search(tree, 5));
+    assert(!savl_index(tree, 1));
+    assert(!savl_peek_min(tree) && !savl_peek_max(tree));
+    assert(!savl_delete(tree, 5) && !savl_pop_min(tree, &value));
+
+    assert(savl_insert(tree, 5));
+    assert(savl_insert(tree, 3));
+    assert(!savl_insert(tree, 3));
+    assert(savl_insert(tree, 8));
+    assert(tree->length == 3 && tree->height == 2);
+    assert(savl_get_index(tree, 8) == 3);
+    assert(savl_peek_min(tree)->value == 3);
+
+    assert(savl_delete_at(tree, 2, &value) && value == 5);
+    assert(savl_pop_max(tree, &value) && value == 8);
+    assert(savl_pop_min(tree, &value) && value == 3);
+    assert(tree->length == 0 && !tree->head && tree->height == 0);
+
+    // ascending inserts take a rotation at every other step
+    char contents[1000] = {0};
+    for (int x=0; x<1000; x++) {
+        savl_insert(tree, x);
+        contents[x] = 1;
+    }
+    check_tree(tree, contents, 1000);
+
+    printf("Standard tests passed\n");
+    savl_clear_destroy(tree);
+    return 0;
+}
+
+
+int random_tests(int range, int ops)
+{
+    savl* tree = savl_create();
+    char* contents = calloc(range, 1);
+    int value;
+
+    srand(time(NULL));
+    for (int i=0; i<ops; i++) {
+        int x = rand() % range;
+        int op = rand() % 6;
+
+        if (op < 3) {
+            assert(savl_insert(tree, x) == !contents[x]);
+            contents[x] = 1;
+        } else if (op == 3) {
+            assert(savl_delete(tree, x) == contents[x]);
+            contents[x] = 0;
+        } else if (op == 4 && tree->length) {
+            int rank = rand() % tree->length + 1;
+            int expected = savl_index(tree, rank)->value;
+            assert(savl_delete_at(tree, rank, &value) && value == expected);
+            contents[value] = 0;
+        } else if (op == 5) {
+            int length = tree->length;
+            int popped = (rand() & 1) ? savl_pop_min(tree, &value) : savl_pop_max(tree, &value);
+            assert(popped == (length > 0));
+            if (popped) {
+                assert(contents[value]);
+                contents[value] = 0;
+            }
+        }
+
+        if (i % (ops / 20) == 0)
+            check_tree(tree, contents, range);
+    }
+
+    check_tree(tree, contents, range);
+
+    // and empty it entirely
+    while (tree->length)
+        savl_delete_at(tree, rand() % tree->length + 1, NULL);
+    assert(!tree->head && tree->height == 0);
+
+    printf("Random tests passed\n");
+    free(contents);
+    savl_clear_destroy(tree);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    standard_tests();
+    random_tests(100, 20000);
+    random_tests(5000, 100000);
+
+    return 0;
+}
@@ -0,0 +1,485 @@
+/*
+ * savl.c
+ *
+ * A compact AVL tree without parent pointers.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "savl.h"
+
+/*
+ * The search path of an insert or delete. Rather than the nodes themselves,
+ * the stack holds the slots pointing at them (the head of the tree, or a
+ * child pointer of the node above), so a rotation can replace the subtree
+ * root in place. dirs[i] is the direction taken from the node in slots[i].
+ */
+typedef struct SAVLPath {
+    savlnode** slots[SAVL_MAX_HEIGHT];
+    int dirs[SAVL_MAX_HEIGHT];
+    int depth;
+} savl_path;
+
+
+static savlnode* _savl_node_create(int value)
+{
+    savlnode* newnode = malloc(sizeof(savlnode));
+    if (!newnode) {
+        fprintf(stderr, "MEMORY ERROR in _savl_node_create. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    newnode->value = value;
+    newnode->rank = 1;
+    newnode->balance_factor = EVEN;
+    newnode->left = NULL;
+    newnode->right = NULL;
+
+    return newnode;
+}
+
+
+savl* savl_create(void)
+{
+    savl* tree = malloc(sizeof(savl));
+    if (!tree) {
+        fprintf(stderr, "MEMORY ERROR in savl_create. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    tree->length = 0;
+    tree->height = 0;
+    tree->head = NULL;
+
+    return tree;
+}
+
+
+static savlnode* _savl_rotate_left(savlnode* center)
+{
+    // returns the new root of the subtree, which the caller links in
+    savlnode* pivot = center->right;
+
+    center->right = pivot->left;
+    pivot->left = center;
+    pivot->rank += center->rank;
+
+    return pivot;
+}
+
+
+static savlnode* _savl_rotate_right(savlnode* center)
+{
+    savlnode* pivot = center->left;
+
+    center->left = pivot->right;
+    pivot->right = center;
+    center->rank -= pivot->rank;
+
+    return pivot;
+}
+
+
+static savlnode* _savl_rebalance(savlnode* head, int direction, int* shrunk)
+{
+    // Rebalances a subtree that is two levels too tall in direction,
+    // returning its new root. shrunk is set if the subtree ended up shorter
+    // than it was before rebalancing, which is only not the case after a
+    // delete that left the child in direction even.
+    savlnode* child = (direction == RIGHT) ? head->right : head->left;
+
+    if (child->balance_factor == -direction) {
+        savlnode* grandchild = (direction == RIGHT) ? child->left : child->right;
+        int balance = grandchild->balance_factor;
+
+        if (direction == RIGHT) {
+            head->right = _savl_rotate_right(child);
+            _savl_rotate_left(head);
+        } else {
+            head->left = _savl_rotate_left(child);
+            _savl_rotate_right(head);
+        }
+
+        head->balance_factor = (balance == direction) ? -direction : EVEN;
+        child->balance_factor = (balance == -direction) ? direction : EVEN;
+        grandchild->balance_factor = EVEN;
+
+        *shrunk = 1;
+        return grandchild;
+    }
+
+    if (direction == RIGHT)
+        _savl_rotate_left(head);
+    else
+        _savl_rotate_right(head);
+
+    if (child->balance_factor == EVEN) {
+        head->balance_factor = direction;
+        child->balance_factor = -direction;
+        *shrunk = 0;
+    } else {
+        head->balance_factor = EVEN;
+        child->balance_factor = EVEN;
+        *shrunk = 1;
+    }
+
+    return child;
+}
+
+
+int savl_insert(savl* tree, int value)
+{
+    savl_path path;
+    path.depth = 0;
+
+    savlnode** slot = &tree->head;
+    while (*slot) {
+        savlnode* current = *slot;
+        if (value == current->value) return 0;
+
+        path.slots[path.depth] = slot;
+        if (value < current->value) {
+            path.dirs[path.depth++] = LEFT;
+            slot = &current->left;
+        } else {
+            path.dirs[path.depth++] = RIGHT;
+            slot = &current->right;
+        }
+    }
+
+    assert(tree->length < SAVL_MAX_LENGTH);
+    *slot = _savl_node_create(value);
+    tree->length++;
+
+    // only now is it known that the ranks need updating
+    for (int i=0; i<path.depth; i++) {
+        if (path.dirs[i] == LEFT)
+            (*path.slots[i])->rank++;
+    }
+
+    // Retrace until a subtree absorbs the extra height, either by becoming
+    // even or with a rotation (which restores its original height).
+    for (int i=path.depth-1; i>=0; i--) {
+        savlnode* current = *path.slots[i];
+        int direction = path.dirs[i];
+
+        if (current->balance_factor == -direction) {
+            current->balance_factor = EVEN;
+            return 1;
+        }
+
+        if (current->balance_factor == direction) {
+            int shrunk;
+            *path.slots[i] = _savl_rebalance(current, direction, &shrunk);
+            return 1;
+        }
+
+        current->balance_factor = direction;
+    }
+
+    tree->height++;
+    return 1;
+}
+
+
+static void _savl_remove(savl* tree, savl_path* path)
+{
+    // Removes the node at the top of path, which runs from the root down to
+    // it, and frees it.
+    int top = path->depth - 1;
+    savlnode* target = *path->slots[top];
+
+    for (int i=0; i<top; i++) {
+        if (path->dirs[i] == LEFT)
+            (*path->slots[i])->rank--;
+    }
+
+    if (target->left && target->right) {
+        // The successor takes target's place, so the path continues down to
+        // it, each node on the way losing it from its left subtree.
+        path->dirs[top] = RIGHT;
+        savlnode** slot = &target->right;
+        while ((*slot)->left) {
+            (*slot)->rank--;
+            path->slots[path->depth] = slot;
+            path->dirs[path->depth++] = LEFT;
+            slot = &(*slot)->left;
+        }
+
+        savlnode* successor = *slot;
+        *slot = successor->right;
+
+        successor->left = target->left;
+        successor->right = target->right;
+        successor->rank = target->rank;
+        successor->balance_factor = target->balance_factor;
+        *path->slots[top] = successor;
+
+        // the slot below target's position was one of its fields
+        if (path->depth > top + 1)
+            path->slots[top + 1] = &successor->right;
+    } else {
+        *path->slots[top] = (target->left) ? target->left : target->right;
+        path->depth--;
+    }
+
+    free(target);
+    tree->length--;
+
+    // Retrace until a subtree keeps its height, either by going from even
+    // to leaning, or with a rotation around an even child.
+    for (int i=path->depth-1; i>=0; i--) {
+        savlnode* current = *path->slots[i];
+        int direction = path->dirs[i];
+
+        if (current->balance_factor == direction) {
+            current->balance_factor = EVEN;
+            continue;
+        }
+
+        if (current->balance_factor == EVEN) {
+            current->balance_factor = -direction;
+            return;
+        }
+
+        int shrunk;
+        *path->slots[i] = _savl_rebalance(current, -direction, &shrunk);
+        if (!shrunk) return;
+    }
+
+    tree->height--;
+}
+
+
+int savl_delete(savl* tree, int value)
+{
+    savl_path path;
+    path.depth = 0;
+
+    savlnode** slot = &tree->head;
+    while (*slot && (*slot)->value != value) {
+        path.slots[path.depth] = slot;
+        if (value < (*slot)->value) {
+            path.dirs[path.depth++] = LEFT;
+            slot = &(*slot)->left;
+        } else {
+            path.dirs[path.depth++] = RIGHT;
+            slot = &(*slot)->right;
+        }
+    }
+
+    if (!*slot) {
+        return 0;
+    }
+
+    path.slots[path.depth++] = slot;
+    _savl_remove(tree, &path);
+
+    return 1;
+}
+
+
+int savl_delete_at(savl* tree, int rank, int* value)
+{
+    // Deletes the node with the given rank, storing its value in value (if
+    // it isn't NULL).
+    if (rank > tree->length || rank <= 0) return 0;
+
+    savl_path path;
+    path.depth = 0;
+
+    savlnode** slot = &tree->head;
+    while (rank != (*slot)->rank) {
+        path.slots[path.depth] = slot;
+        if (rank < (*slot)->rank) {
+            path.dirs[path.depth++] = LEFT;
+            slot = &(*slot)->left;
+        } else {
+            rank -= (*slot)->rank;
+            path.dirs[path.depth++] = RIGHT;
+            slot = &(*slot)->right;
+        }
+    }
+
+    if (value) *value = (*slot)->value;
+    path.slots[path.depth++] = slot;
+    _savl_remove(tree, &path);
+
+    return 1;
+}
+
+
+int savl_pop_min(savl* tree, int* value)
+{
+    return savl_delete_at(tree, 1, value);
+}
+
+
+int savl_pop_max(savl* tree, int* value)
+{
+    return savl_delete_at(tree, tree->length, value);
+}
+
+
+savlnode* savl_search(savl* tree, int value)
+{
+    savlnode* current = tree->head;
+
+    while (current && current->value != value)
+        current = (value < current->value) ? current->left : current->right;
+
+    return current;
+}
+
+
+savlnode* savl_index(savl* tree, int index)
+{
+    if (index > tree->length || index <= 0) return NULL;
+
+    savlnode* current = tree->head;
+    while (current) {
+        if (index == current->rank) return current;
+
+        if (index < current->rank) current = current->left;
+        else {
+            index = index - current->rank;
+            current = current->right;
+        }
+    }
+
+    return NULL;
+}
+
+
+int savl_get_index(savl* tree, int value)
+{
+    savlnode* current = tree->head;
+    int index = 0;
+
+    while (current)  {
+        if (current->value == value) {
+            return index + current->rank;
+        }
+        if (value < current->value){
+            current = current->left;
+        }
+        else {
+            index += current->rank;
+            current = current->right;
+        }
+    }
+
+    return -1;
+}
+
+
+savlnode* savl_peek_min(savl* tree)
+{
+    savlnode* current = tree->head;
+    while (current && current->left)
+        current = current->left;
+
+    return current;
+}
+
+
+savlnode* savl_peek_max(savl* tree)
+{
+    savlnode* current = tree->head;
+    while (current && current->right)
+        current = current->right;
+
+    return current;
+}
+
+
+static savlnode* _savl_first_above(savl* tree, int value, int inclusive, int* rank)
+{
+    // the smallest node greater than (or, if inclusive, equal to) value,
+    // with rank set to its index (or length + 1 if there is no such node)
+    savlnode* current = tree->head;
+    savlnode* found = NULL;
+    int index = 0;
+    int found_index = tree->length + 1;
+
+    while (current) {
+        if (current->value > value || (inclusive && current->value == value)) {
+            found = current;
+            found_index = index + current->rank;
+            current = current->left;
+        } else {
+            index += current->rank;
+            current = current->right;
+        }
+    }
+
+    if (rank) *rank = found_index;
+    return found;
+}
+
+
+savlnode* savl_lower_bound(savl* tree, int value, int* rank)
+{
+    return _savl_first_above(tree, value, 1, rank);
+}
+
+
+savlnode* savl_upper_bound(savl* tree, int value, int* rank)
+{
+    return _savl_first_above(tree, value, 0, rank);
+}
+
+
+savlnode* savl_next(savl* tree, savlnode* current)
+{
+    // Without parent pointers, each step is a fresh descent.
+    return savl_upper_bound(tree, current->value, NULL);
+}
+
+
+savlnode* savl_prev(savl* tree, savlnode* current)
+{
+    savlnode* node = tree->head;
+    savlnode* found = NULL;
+
+    while (node) {
+        if (node->value < current->value) {
+            found = node;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+
+    return found;
+}
+
+
+static void _savl_free(savlnode* head)
+{
+    if (!head) return;
+
+    _savl_free(head->left);
+    _savl_free(head->right);
+    free(head);
+}
+
+
+void savl_clear(savl* tree)
+{
+    _savl_free(tree->head);
+    tree->head = NULL;
+    tree->length = 0;
+    tree->height = 0;
+}
+
+
+void savl_clear_destroy(savl* tree)
+{
+    savl_clear(tree);
+    free(tree);
+}
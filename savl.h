@@ -0,0 +1,71 @@
+/*
+ * savl.h
+ *
+ * A compact AVL tree without parent pointers. Inserts and deletes record
+ * their search path on a fixed-size stack as they descend, and retrace it
+ * bottom-up afterwards, so no node needs to know its parent. Rotations then
+ * only rewrite the child pointers of the nodes involved and the one slot
+ * that pointed at the old subtree root, rather than up to three parent links
+ * and a comparison to find the parent's slot (as bst_rotate has to).
+ *
+ * The balance factor is packed into the rank word, making a node 24 bytes
+ * rather than the 40 of a bstnode, which takes a 32 byte rather than a 48
+ * byte malloc chunk. The price is that a tree can hold at most
+ * SAVL_MAX_LENGTH keys, and that iterating (savl_next and savl_prev) costs a
+ * descent per step.
+ *
+ * Ranks are maintained as in the avl_ functions, and only written on nodes
+ * whose left subtree actually changed, once the operation is known to
+ * succeed. The augmentation, exact-match index, lazy deletion and tracing
+ * options of the bst based tree aren't supported.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include <assert.h>
+#include "bst.h"
+
+// the most keys a tree can hold, as a rank has to fit in 30 bits
+#define SAVL_MAX_LENGTH ((1 << 29) - 1)
+
+// An AVL tree of 2^29 keys is at most 1.44 lg(2^29) < 42 nodes tall, so the
+// path stack never overflows.
+#define SAVL_MAX_HEIGHT 48
+
+typedef struct SAVLNode {
+    int value;
+    signed int balance_factor : 2;
+    unsigned int rank : 30;
+    struct SAVLNode* left;
+    struct SAVLNode* right;
+} savlnode;
+
+typedef struct SAVL {
+    int length;
+    int height;
+    savlnode* head;
+} savl;
+
+savl* savl_create(void);
+
+int savl_insert(savl* tree, int value);
+int savl_delete(savl* tree, int value);
+int savl_delete_at(savl* tree, int rank, int* value);
+int savl_pop_min(savl* tree, int* value);
+int savl_pop_max(savl* tree, int* value);
+
+savlnode* savl_search(savl* tree, int value);
+savlnode* savl_index(savl* tree, int index);
+int savl_get_index(savl* tree, int value);
+savlnode* savl_peek_min(savl* tree);
+savlnode* savl_peek_max(savl* tree);
+savlnode* savl_lower_bound(savl* tree, int value, int* rank);
+savlnode* savl_upper_bound(savl* tree, int value, int* rank);
+savlnode* savl_next(savl* tree, savlnode* current);
+savlnode* savl_prev(savl* tree, savlnode* current);
+
+void savl_clear(savl* tree);
+void savl_clear_destroy(savl* tree);
@@ -0,0 +1,220 @@
+/*
+ * seq-test.c
+ * A simple test suite for the sequence mode, checking the contents, AVL
+ * balance, ranks, heights, parent links and cached extremes of sequences
+ * against plain arrays, through random inserts and deletes by position,
+ * and concatenations and splits of every shape.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+
+#include "seq.h"
+#include "bst-util.h"
+
+
+void check_seq(bst* seq, const bst_key* expected, bst_size length)
+{
+    assert(seq->length == length);
+    assert(check_balance_factors(seq->head) == seq->height);
+    assert(check_subtree_ranks(seq->head) == length);
+    if (seq->head) assert(!seq->head->parent);
+    check_parent_links(seq->head);
+    check_extremes(seq);
+
+    bst_size position = 0;
+    for (bstnode* node = bst_node_min(seq->head); node; node = bst_node_next(node)) {
+        assert(node->value == expected[position]);
+        position++;
+    }
+    assert(position == length);
+
+    for (bst_size i = 1; i <= length; i += 1 + length / 64)
+        assert(seq_get(seq, i)->value == expected[i - 1]);
+    assert(!seq_get(seq, 0) && !seq_get(seq, length + 1));
+}
+
+
+int standard_tests()
+{
+    bst* seq = seq_create();
+    bst_key expected[8] = {3, 1, 4, 1, 5, 9, 2, 6};
+
+    // duplicates are fine, as values aren't keys
+    for (int i = 0; i < 8; i++)
+        assert(seq_append(seq, expected[i]));
+    check_seq(seq, expected, 8);
+
+    assert(!seq_insert_at(seq, 0, 7) && !seq_insert_at(seq, 10, 7));
+
+    bst_key value;
+    assert(seq_delete_at(seq, 1, &value) && value == 3);
+    assert(seq_delete_at(seq, 7, &value) && value == 6);
+    assert(!seq_delete_at(seq, 7, &value));
+    check_seq(seq, expected + 1, 6);
+
+    assert(seq_insert_at(seq, 1, 3));
+    assert(seq_insert_at(seq, 8, 6));
+    check_seq(seq, expected, 8);
+
+    printf("Passed\n");
+
+    avl_clear_destroy(seq);
+    return 0;
+}
+
+
+int edit_tests(int n)
+{
+    bst* seq = seq_create();
+    bst_key* expected = malloc(sizeof(bst_key) * n);
+    bst_size length = 0;
+
+    srand(time(NULL));
+    printf("Checking random inserts and deletes by position...\n");
+    for (int i = 0; i < 4 * n; i++) {
+        if (length < n && (rand() % 3 || !length)) {
+            bst_size position = rand() % (length + 1) + 1;
+            bst_key value = rand() % 100;
+
+            assert(seq_insert_at(seq, position, value));
+            memmove(expected + position, expected + position - 1, sizeof(bst_key) * (length - position + 1));
+            expected[position - 1] = value;
+            length++;
+        } else {
+            bst_size position = rand() % length + 1;
+            bst_key value;
+
+            assert(seq_delete_at(seq, position, &value) && value == expected[position - 1]);
+            memmove(expected + position - 1, expected + position, sizeof(bst_key) * (length - position));
+            length--;
+        }
+
+        if (i % 1000 == 0)
+            check_seq(seq, expected, length);
+    }
+    check_seq(seq, expected, length);
+
+    printf("Passed\n");
+
+    free(expected);
+    avl_clear_destroy(seq);
+    return 0;
+}
+
+
+bst* build(bst_key first, bst_size length, bst_key* expected)
+{
+    // a sequence of consecutive values, built from random positions so that
+    // its shape isn't the one appends would give
+    bst* seq = seq_create();
+    for (bst_size i = 0; i < length; i++) {
+        seq_insert_at(seq, rand() % (i + 1) + 1, 0);
+        expected[i] = first + i;
+    }
+
+    bst_size i = 0;
+    for (bstnode* node = bst_node_min(seq->head); node; node = bst_node_next(node))
+        node->value = first + i++;
+
+    return seq;
+}
+
+
+int concat_split_tests(int n)
+{
+    bst_key* expected = malloc(sizeof(bst_key) * 2 * n);
+
+    srand(time(NULL));
+    printf("Checking concatenation of sequences of all sizes...\n");
+    for (int i = 0; i < 2000; i++) {
+        // mostly lopsided pairs, as they need the spine to be walked
+        bst_size a = (i % 4) ? rand() % n : rand() % 8;
+        bst_size b = (i % 3) ? rand() % n : rand() % 8;
+
+        bst* left = build(0, a, expected);
+        bst* right = build(a, b, expected + a);
+
+        seq_concat(left, right);
+        check_seq(left, expected, a + b);
+        check_seq(right, NULL, 0);
+
+        avl_clear_destroy(left);
+        avl_clear_destroy(right);
+    }
+
+    printf("Checking splits at every kind of position...\n");
+    for (int i = 0; i < 2000; i++) {
+        bst_size length = rand() % n;
+        bst_size position = (i % 5 == 0) ? 0 : (i % 5 == 1) ? length : rand() % (length + 1);
+
+        bst* seq = build(0, length, expected);
+        bst* rest = seq_split(seq, position);
+        check_seq(seq, expected, position);
+        check_seq(rest, expected + position, length - position);
+
+        // and put back together, which should give the original
+        seq_concat(seq, rest);
+        check_seq(seq, expected, length);
+
+        avl_clear_destroy(seq);
+        avl_clear_destroy(rest);
+    }
+
+    printf("Checking edits between splits and joins...\n");
+    bst_size length = n;
+    bst* seq = build(0, length, expected);
+    for (int i = 0; i < 2000; i++) {
+        // cut a random piece out and move it to the end
+        bst_size from = rand() % (length + 1);
+        bst_size to = from + rand() % (length - from + 1);
+
+        bst* middle = seq_split(seq, from);
+        bst* end = seq_split(middle, to - from);
+        seq_concat(seq, end);
+        seq_concat(seq, middle);
+
+        bst_key* moved = malloc(sizeof(bst_key) * (to - from + 1));
+        memcpy(moved, expected + from, sizeof(bst_key) * (to - from));
+        memmove(expected + from, expected + to, sizeof(bst_key) * (length - to));
+        memcpy(expected + length - (to - from), moved, sizeof(bst_key) * (to - from));
+        free(moved);
+
+        assert(seq_insert_at(seq, from + 1, -i));
+        memmove(expected + from + 1, expected + from, sizeof(bst_key) * (length - from));
+        expected[from] = -i;
+        length++;
+
+        if (i % 100 == 0 || length < 16)
+            check_seq(seq, expected, length);
+
+        avl_clear_destroy(middle);
+        avl_clear_destroy(end);
+
+        if (length == 2 * n - 1) break;
+    }
+    check_seq(seq, expected, length);
+
+    printf("Passed\n");
+
+    avl_clear_destroy(seq);
+    free(expected);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    standard_tests();
+    edit_tests(5000);
+    concat_split_tests(300);
+
+    return 0;
+}
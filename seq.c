@@ -0,0 +1,320 @@
+/*
+ * seq.c
+ *
+ * An AVL tree as a sequence container, keyed by position.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "seq.h"
+
+/*
+ * A detached subtree, with the height and length a join needs, so that
+ * neither has to be recomputed from the nodes.
+ */
+typedef struct SeqPart {
+    bstnode* head;
+    int height;
+    bst_size length;
+} seq_part;
+
+
+bst* seq_create(void)
+{
+    return avl_create();
+}
+
+
+static int _seq_retrace_growth(bst* tree, bstnode* grown)
+{
+    // The subtree rooted at grown has just become one taller. Walks up
+    // fixing balance factors, and rotating where a node becomes too heavy,
+    // until the height of a subtree stops changing. Returns 1 if the whole
+    // tree grew.
+    while (grown->parent) {
+        bstnode* parent = grown->parent;
+        int direction = (parent->left == grown) ? LEFT : RIGHT;
+
+        if (parent->balance_factor == EVEN) {
+            parent->balance_factor = direction;
+            grown = parent;
+            continue;
+        }
+
+        if (parent->balance_factor == REVERSE_DIRECTION(direction)) {
+            parent->balance_factor = EVEN;
+            return 0;
+        }
+
+        // After an insert, the rotation always restores the old height. A
+        // join can leave the taller child evenly balanced, though, and then
+        // the single rotation makes the subtree one taller still.
+        int still_growing = (grown->balance_factor == EVEN);
+        avl_rebalance(tree, parent, direction);
+        if (!still_growing) return 0;
+
+        grown = parent->parent;
+    }
+
+    return 1;
+}
+
+
+int seq_insert_at(bst* seq, bst_size position, bst_key value)
+{
+    // Inserts value so that it ends up at position, moving everything from
+    // there on back by one. position may be one past the end, to append.
+    if (position < 1 || position > seq->length + 1)
+        return 0;
+
+    bstnode* newnode = bst_create_node(seq, value);
+    newnode->balance_factor = EVEN;
+
+    if (position == 1)
+        seq->leftmost = newnode;
+    if (position == seq->length + 1)
+        seq->rightmost = newnode;
+    seq->length++;
+
+    if (!seq->head) {
+        seq->head = newnode;
+        seq->height = 1;
+        return 1;
+    }
+
+    // the ranks are fixed on the way down, as the insert can't fail
+    bstnode* current = seq->head;
+    for (;;) {
+        if (position <= current->rank) {
+            current->rank++;
+            if (!current->left) {
+                current->left = newnode;
+                break;
+            }
+            current = current->left;
+        } else {
+            position -= current->rank;
+            if (!current->right) {
+                current->right = newnode;
+                break;
+            }
+            current = current->right;
+        }
+    }
+
+    newnode->parent = current;
+    if (_seq_retrace_growth(seq, newnode))
+        seq->height++;
+
+    return 1;
+}
+
+
+int seq_append(bst* seq, bst_key value)
+{
+    return seq_insert_at(seq, seq->length + 1, value);
+}
+
+
+int seq_delete_at(bst* seq, bst_size position, bst_key* value)
+{
+    // bst_node_unlink works by position, rather than by key, so this is
+    // just an AVL delete.
+    bstnode* todelete = bst_index(seq, position);
+
+    if (!todelete) {
+        return 0;
+    }
+
+    if (value) *value = todelete->value;
+    avl_node_delete(seq, todelete);
+
+    return 1;
+}
+
+
+bstnode* seq_get(bst* seq, bst_size position)
+{
+    return bst_index(seq, position);
+}
+
+
+static seq_part _seq_join(seq_part left, bstnode* middle, seq_part right)
+{
+    // Joins left, the detached node middle, and right, in that order, into
+    // one balanced subtree. If the heights differ by more than one, middle
+    // goes down the spine of the taller tree, facing the shorter one, to
+    // the first subtree no more than one taller than it, and takes that
+    // subtree's place with the two of them as its children. Only the nodes
+    // above it along the spine need rebalancing, so this costs O(difference
+    // in heights).
+    seq_part joined = {NULL, 0, left.length + right.length + 1};
+
+    // rotations above middle may change the root, which bst_rotate records
+    // in tree->head
+    bst scratch;
+    memset(&scratch, 0, sizeof(bst));
+
+    middle->parent = NULL;
+    middle->rank = left.length + 1;
+
+    if (abs(left.height - right.height) <= 1) {
+        middle->left = left.head;
+        middle->right = right.head;
+        middle->balance_factor = right.height - left.height;
+        if (left.head) left.head->parent = middle;
+        if (right.head) right.head->parent = middle;
+
+        joined.head = middle;
+        joined.height = ((left.height > right.height) ? left.height : right.height) + 1;
+        return joined;
+    }
+
+    bstnode* parent = NULL;
+    if (left.height > right.height) {
+        bstnode* current = left.head;
+        int height = left.height;
+        bst_size length = left.length;
+
+        while (height > right.height + 1) {
+            height -= (current->balance_factor == LEFT) ? 2 : 1;
+            length -= current->rank;
+            parent = current;
+            current = current->right;
+        }
+
+        middle->left = current;
+        middle->right = right.head;
+        middle->rank = length + 1;
+        middle->balance_factor = right.height - height;
+        parent->right = middle;
+        scratch.head = left.head;
+        joined.height = left.height;
+
+        if (current) current->parent = middle;
+        if (right.head) right.head->parent = middle;
+    } else {
+        bstnode* current = right.head;
+        int height = right.height;
+
+        // everything down the left spine gains left and middle on its left
+        while (height > left.height + 1) {
+            height -= (current->balance_factor == RIGHT) ? 2 : 1;
+            current->rank += left.length + 1;
+            parent = current;
+            current = current->left;
+        }
+
+        middle->left = left.head;
+        middle->right = current;
+        middle->balance_factor = height - left.height;
+        parent->left = middle;
+        scratch.head = right.head;
+        joined.height = right.height;
+
+        if (current) current->parent = middle;
+        if (left.head) left.head->parent = middle;
+    }
+
+    middle->parent = parent;
+
+    // middle's subtree is one taller than the one it replaced
+    if (_seq_retrace_growth(&scratch, middle))
+        joined.height++;
+
+    joined.head = scratch.head;
+    return joined;
+}
+
+
+static seq_part _seq_detach(bstnode* head, int height, bst_size length, int direction)
+{
+    // the child subtree of head in the given direction, cut loose
+    bstnode* child = BRANCH(direction, head);
+    seq_part part = {child, height - 1 - (head->balance_factor == REVERSE_DIRECTION(direction)),
+        (direction == LEFT) ? head->rank - 1 : length - head->rank};
+
+    if (child) child->parent = NULL;
+    return part;
+}
+
+
+static void _seq_split(seq_part whole, bst_size position, seq_part* before, seq_part* after)
+{
+    // Splits whole into its first position elements and the rest. Each
+    // level down the search path joins the subtree it leaves behind to one
+    // side of the result, and as the heights of those subtrees only grow on
+    // the way back up, the joins cost O(lg n) in all.
+    if (!whole.head) {
+        *before = *after = whole;
+        return;
+    }
+
+    bstnode* head = whole.head;
+    seq_part left = _seq_detach(head, whole.height, whole.length, LEFT);
+    seq_part right = _seq_detach(head, whole.height, whole.length, RIGHT);
+    head->left = head->right = NULL;
+
+    if (position < head->rank) {
+        seq_part inner;
+        _seq_split(left, position, before, &inner);
+        *after = _seq_join(inner, head, right);
+    } else {
+        seq_part inner;
+        _seq_split(right, position - head->rank, &inner, after);
+        *before = _seq_join(left, head, inner);
+    }
+}
+
+
+static void _seq_adopt(bst* seq, seq_part part)
+{
+    seq->head = part.head;
+    seq->height = part.height;
+    seq->length = part.length;
+    seq->leftmost = bst_node_min(part.head);
+    seq->rightmost = bst_node_max(part.head);
+}
+
+
+void seq_concat(bst* seq, bst* other)
+{
+    // Appends the elements of other to seq, leaving other empty. The first
+    // element of other becomes the node the two trees are joined around.
+    if (!other->length) return;
+
+    bstnode* middle = other->leftmost;
+    avl_node_unlink(other, middle);
+
+    seq_part left = {seq->head, seq->height, seq->length};
+    seq_part right = {other->head, other->height, other->length};
+    _seq_adopt(seq, _seq_join(left, middle, right));
+
+    other->head = other->leftmost = other->rightmost = NULL;
+    other->length = 0;
+    other->height = 0;
+}
+
+
+bst* seq_split(bst* seq, bst_size position)
+{
+    // Keeps the first position elements in seq, and returns a new sequence
+    // of the rest.
+    if (position < 0) position = 0;
+    if (position > seq->length) position = seq->length;
+
+    seq_part whole = {seq->head, seq->height, seq->length};
+    seq_part before, after;
+    _seq_split(whole, position, &before, &after);
+
+    bst* rest = seq_create();
+    _seq_adopt(seq, before);
+    _seq_adopt(rest, after);
+
+    return rest;
+}
@@ -0,0 +1,40 @@
+/*
+ * seq.h
+ *
+ * The AVL tree as a sequence container (a rope), in which the position of
+ * an element is its only key. Ranks already give the element at a position
+ * in O(lg n), and here they also decide where an element is inserted, so
+ * inserting or deleting in the middle of a sequence costs O(lg n), where an
+ * array would have to move everything after it.
+ *
+ * Sequences are ordinary bst trees, rebalanced with avl_rebalance and the
+ * rank-maintaining bst_rotate, and node->value holds the element. So
+ * seq_get returns the node, the iterators (bst_node_next and prev) walk the
+ * sequence in order, and avl_clear_destroy frees it. The functions that
+ * treat the value as a key (avl_insert, avl_search and the like) mustn't be
+ * used on a sequence, and augmentation, the exact-match index, the front
+ * cache, lazy deletes and tracing aren't supported. Nor is
+ * avl_compact_incremental, which finds where to resume by key, though
+ * avl_compact, which moves every node in a single pass, is.
+ *
+ * Two sequences can be concatenated, and a sequence split at a position, in
+ * O(lg n), by joining the trees around a single node and rebalancing only
+ * along the spine where they meet.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include "avl.h"
+
+bst* seq_create(void);
+
+int seq_insert_at(bst* seq, bst_size position, bst_key value);
+int seq_delete_at(bst* seq, bst_size position, bst_key* value);
+int seq_append(bst* seq, bst_key value);
+bstnode* seq_get(bst* seq, bst_size position);
+
+void seq_concat(bst* seq, bst* other);
+bst* seq_split(bst* seq, bst_size position);
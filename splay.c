@@ -0,0 +1,135 @@
+/*
+ * splay.c
+ *
+ * An implementation of the Splay Tree
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "splay.h"
+
+
+bst* splay_create(void)
+{
+    return bst_create();
+}
+
+
+void splay(bst* tree, bstnode* target)
+{
+    while (target->parent) {
+        bstnode* parent = target->parent;
+        bstnode* grandparent = parent->parent;
+        int side = (parent->left == target) ? LEFT : RIGHT;
+
+        if (!grandparent) {
+            // zig
+            bst_rotate(tree, parent, REVERSE_DIRECTION(side));
+            continue;
+        }
+
+        int parent_side = (grandparent->left == parent) ? LEFT : RIGHT;
+
+        if (side == parent_side) {
+            // zig-zig
+            bst_rotate(tree, grandparent, REVERSE_DIRECTION(side));
+            bst_rotate(tree, parent, REVERSE_DIRECTION(side));
+        } else {
+            // zig-zag
+            bst_rotate(tree, parent, REVERSE_DIRECTION(side));
+            bst_rotate(tree, grandparent, REVERSE_DIRECTION(parent_side));
+        }
+    }
+}
+
+
+int splay_insert(bst* tree, bst_key value)
+{
+    bstnode* newnode = bst_create_node(tree, value);
+
+    if (tree->length == 0) {
+        bst_node_insert(tree, newnode, NULL);
+        return 1;
+    }
+
+    node* path_tracker = init_update_tracker();
+    bstnode* insert_location = bst_find_node_and_path(tree, value, &path_tracker, 1);
+
+    if (insert_location) {
+        revert_rank_updates(path_tracker, -1);
+        destroy_update_tracker(path_tracker);
+        free(newnode);
+        splay(tree, insert_location);
+        return 0;
+    }
+
+    bst_node_insert(tree, newnode, path_tracker);
+    destroy_update_tracker(path_tracker);
+
+    splay(tree, newnode);
+
+    return 1;
+}
+
+
+int splay_delete(bst* tree, bst_key value)
+{
+    bstnode* todelete = splay_search(tree, value);
+
+    if (!todelete) {
+        return 0;
+    }
+
+    int direction;
+    bstnode* parent = bst_node_unlink(tree, todelete, &direction);
+    bst_free_node(tree, todelete);
+
+    if (parent)
+        splay(tree, parent);
+
+    return 1;
+}
+
+
+bstnode* splay_search(bst* tree, bst_key value)
+{
+    bstnode* current = tree->head;
+    bstnode* last = NULL;
+
+    while (current) {
+        last = current;
+        if (current->value == value)
+            break;
+
+        current = current->value > value ? current->left : current->right;
+    }
+
+    if (last)
+        splay(tree, last);
+
+    return current;
+}
+
+
+bstnode* splay_index(bst* tree, bst_size index)
+{
+    bstnode* found = bst_index(tree, index);
+
+    if (found)
+        splay(tree, found);
+
+    return found;
+}
+
+
+bst_size splay_get_index(bst* tree, bst_key value)
+{
+    bstnode* found = splay_search(tree, value);
+
+    // the found node is now the root, so its rank is its index
+    return (found) ? found->rank : -1;
+}
@@ -0,0 +1,32 @@
+/*
+ * splay.h
+ *
+ * An implementation of the Splay Tree, built on the same node and tree
+ * objects as the bst and avl modules. Every access rotates the accessed node
+ * (or the last node visited, if the search failed) to the root, using the
+ * rank-maintaining bst rotations. This suits skewed access patterns, where
+ * frequently used keys stay near the root.
+ *
+ * Note that, unlike the other trees, even read operations restructure a
+ * splay tree.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include "nodes.h"
+#include <assert.h>
+#include "bst.h"
+#include "tracker.h"
+
+bst* splay_create(void);
+
+int splay_insert(bst* tree, bst_key value);
+int splay_delete(bst* tree, bst_key value);
+bstnode* splay_search(bst* tree, bst_key value);
+bstnode* splay_index(bst* tree, bst_size index);
+bst_size splay_get_index(bst* tree, bst_key value);
+
+void splay(bst* tree, bstnode* target);
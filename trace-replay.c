@@ -0,0 +1,155 @@
+/*
+ * trace-replay.c
+ * Re-executes a trace recorded with avl_start_trace (see trace.h) against one
+ * or all of the balancing policies, so that changes can be benchmarked
+ * against exactly the same workload every time.
+ *
+ * Usage: trace-replay <trace> [policy]
+ *      Each policy replays the trace twice: once back to back, for the
+ *      throughput, and once timing every operation, for the latency
+ *      distribution of each kind of operation. The per-operation timings
+ *      include the cost of reading the clock (tens of ns).
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "policy.h"
+#include "trace.h"
+
+
+static double _elapsed_ns(struct timespec* start, struct timespec* stop)
+{
+    return (stop->tv_sec - start->tv_sec) * 1e9 + (stop->tv_nsec - start->tv_nsec);
+}
+
+
+static int _compare_doubles(const void* a, const void* b)
+{
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+
+    return (x > y) - (x < y);
+}
+
+
+static long _execute(const balance_policy* policy, bst* tree, const trace_record* record)
+{
+    switch (record->op) {
+        case TRACE_INSERT:
+            return policy->insert(tree, record->arg);
+        case TRACE_DELETE:
+            return policy->delete(tree, record->arg);
+        case TRACE_SEARCH:
+            return (long) policy->search(tree, record->arg);
+        case TRACE_INDEX:
+            return (long) policy->index(tree, record->arg);
+        case TRACE_GET_INDEX:
+            return policy->get_index(tree, record->arg);
+    }
+
+    return 0;
+}
+
+
+static void _replay(const balance_policy* policy, const trace_record* records, size_t n)
+{
+    struct timespec start, stop;
+    volatile long sink = 0;
+
+    bst* tree = policy->create();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i=0; i<n; i++)
+        sink += _execute(policy, tree, &records[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    policy->clear_destroy(tree);
+
+    double total = _elapsed_ns(&start, &stop);
+    printf("%-8s %-10s %10.1f ns/op %10.2f Mops/s\n", policy->name, "all",
+            total / n, n / total * 1e3);
+
+    // and again, timing each operation, with the timings sorted by kind
+    size_t counts[TRACE_OPS] = {0};
+    for (size_t i=0; i<n; i++)
+        counts[records[i].op]++;
+
+    double* latencies[TRACE_OPS];
+    for (int op=0; op<TRACE_OPS; op++) {
+        latencies[op] = malloc(sizeof(double) * (counts[op] ? counts[op] : 1));
+        if (!latencies[op]) {
+            fprintf(stderr, "Mallocation error in trace-replay.\n");
+            exit(-1);
+        }
+
+        counts[op] = 0;
+    }
+
+    tree = policy->create();
+    for (size_t i=0; i<n; i++) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        sink += _execute(policy, tree, &records[i]);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        int op = records[i].op;
+        latencies[op][counts[op]++] = _elapsed_ns(&start, &stop);
+    }
+    policy->clear_destroy(tree);
+
+    for (int op=0; op<TRACE_OPS; op++) {
+        size_t count = counts[op];
+        if (count) {
+            double sum = 0;
+            for (size_t i=0; i<count; i++)
+                sum += latencies[op][i];
+
+            qsort(latencies[op], count, sizeof(double), _compare_doubles);
+            printf("%-8s %-10s %10zu ops  mean %8.1f  p50 %8.1f  p99 %8.1f  p99.9 %8.1f  max %10.1f ns\n",
+                    policy->name, trace_op_names[op], count, sum / count,
+                    latencies[op][count / 2], latencies[op][(size_t) (count * 0.99)],
+                    latencies[op][(size_t) (count * 0.999)], latencies[op][count - 1]);
+        }
+
+        free(latencies[op]);
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: trace-replay <trace> [policy]\n");
+        return -1;
+    }
+
+    const balance_policy* only = NULL;
+    if (argc > 2 && !(only = balance_policy_find(argv[2]))) {
+        fprintf(stderr, "Unknown policy: %s\n", argv[2]);
+        return -1;
+    }
+
+    size_t n;
+    trace_record* records = bst_trace_load(argv[1], &n);
+    if (!records) {
+        fprintf(stderr, "Unable to read trace: %s\n", argv[1]);
+        return -1;
+    }
+
+    printf("trace: %s, %zu operations\n", argv[1], n);
+    if (n) {
+        if (only) {
+            _replay(only, records, n);
+        } else {
+            for (int i=0; balance_policies[i]; i++)
+                _replay(balance_policies[i], records, n);
+        }
+    }
+
+    free(records);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * trace.c
+ *
+ * Recording and loading operation traces.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "trace.h"
+
+const char* trace_op_names[] = {"insert", "delete", "search", "index", "get_index"};
+
+
+bst_trace* bst_trace_open(const char* path)
+{
+    // Returns NULL if the file can't be created.
+    FILE* file = fopen(path, "wb");
+    if (!file) return NULL;
+
+    bst_trace* trace = malloc(sizeof(bst_trace));
+    if (!trace) {
+        fprintf(stderr, "MEMORY ERROR in bst_trace_open. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    unsigned char version[4] = {BST_TRACE_VERSION, sizeof(bst_key), 0, 0};
+    fwrite(BST_TRACE_MAGIC, 1, 8, file);
+    fwrite(version, 1, 4, file);
+
+    trace->file = file;
+    trace->buffered = 0;
+    trace->records = 0;
+
+    return trace;
+}
+
+
+void bst_trace_record(bst_trace* trace, int op, bst_key arg)
+{
+    unsigned char* record = trace->buffer + trace->buffered * BST_TRACE_RECORD_BYTES;
+    uint64_t bits = (uint64_t) arg;
+
+    record[0] = op;
+    for (size_t i=1; i<BST_TRACE_RECORD_BYTES; i++, bits >>= 8)
+        record[i] = bits;
+
+    trace->records++;
+    if (++trace->buffered == BST_TRACE_BUFFER)
+        bst_trace_flush(trace);
+}
+
+
+void bst_trace_flush(bst_trace* trace)
+{
+    fwrite(trace->buffer, BST_TRACE_RECORD_BYTES, trace->buffered, trace->file);
+    fflush(trace->file);
+    trace->buffered = 0;
+}
+
+
+void bst_trace_close(bst_trace* trace)
+{
+    if (!trace) return;
+
+    bst_trace_flush(trace);
+    fclose(trace->file);
+    free(trace);
+}
+
+
+trace_record* bst_trace_load(const char* path, size_t* count)
+{
+    // Reads a whole trace into memory, so that replaying it doesn't touch
+    // the file. Returns NULL (with count set to 0) if the file can't be read
+    // or isn't a trace.
+    *count = 0;
+
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    unsigned char header[12];
+    if (fread(header, 1, 12, file) != 12 || memcmp(header, BST_TRACE_MAGIC, 8)
+            || header[8] != BST_TRACE_VERSION || header[9] != sizeof(bst_key)) {
+        fclose(file);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    size_t n = (ftell(file) - 12) / BST_TRACE_RECORD_BYTES;
+    fseek(file, 12, SEEK_SET);
+
+    trace_record* records = malloc(sizeof(trace_record) * (n ? n : 1));
+    if (!records) {
+        fprintf(stderr, "MEMORY ERROR in bst_trace_load. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    unsigned char record[BST_TRACE_RECORD_BYTES];
+    for (size_t i=0; i<n; i++) {
+        if (fread(record, 1, BST_TRACE_RECORD_BYTES, file) != BST_TRACE_RECORD_BYTES
+                || record[0] >= TRACE_OPS) {
+            free(records);
+            fclose(file);
+            return NULL;
+        }
+
+        // narrowing to the key type (mod 2^width) restores negative keys
+        uint64_t bits = 0;
+        for (size_t j=BST_TRACE_RECORD_BYTES-1; j>=1; j--)
+            bits = bits << 8 | record[j];
+
+        records[i].op = record[0];
+        records[i].arg = (bst_key) bits;
+    }
+
+    fclose(file);
+    *count = n;
+    return records;
+}
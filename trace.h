@@ -0,0 +1,61 @@
+/*
+ * trace.h
+ *
+ * Operation traces, for benchmarking against a fixed (or captured) workload
+ * rather than a freshly randomized one. While a tree is recording (see
+ * avl_start_trace), each insert, delete, search, index and get_index made
+ * through the avl_ API is appended to a binary log, and trace-replay can then
+ * re-execute the log against any balancing policy.
+ *
+ * The file starts with the 8 byte magic BST_TRACE_MAGIC, a version byte and
+ * the width of a key in bytes (followed by two unused bytes), and then one
+ * record per operation: the operation, and its argument as a little endian
+ * integer of the key width (5 bytes in all, or 9 with BST_64BIT). A trace can
+ * only be loaded by a build with the same key width. Records are buffered, so
+ * the cost while recording is a branch and a few stores per operation.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include <stdio.h>
+#include <stddef.h>
+#include "nodes.h"
+
+#define BST_TRACE_MAGIC "BSTTRACE"
+#define BST_TRACE_VERSION 1
+
+#define TRACE_INSERT 0
+#define TRACE_DELETE 1
+#define TRACE_SEARCH 2
+#define TRACE_INDEX 3
+#define TRACE_GET_INDEX 4
+#define TRACE_OPS 5
+
+#define BST_TRACE_RECORD_BYTES (1 + sizeof(bst_key))
+
+// records buffered before each write to the file
+#define BST_TRACE_BUFFER 4096
+
+typedef struct TraceRecord {
+    int op;
+    bst_key arg;
+} trace_record;
+
+typedef struct BSTTrace {
+    FILE* file;
+    unsigned char buffer[BST_TRACE_BUFFER * BST_TRACE_RECORD_BYTES];
+    int buffered;
+    long long records;
+} bst_trace;
+
+extern const char* trace_op_names[];
+
+bst_trace* bst_trace_open(const char* path);
+void bst_trace_record(bst_trace* trace, int op, bst_key arg);
+void bst_trace_flush(bst_trace* trace);
+void bst_trace_close(bst_trace* trace);
+
+trace_record* bst_trace_load(const char* path, size_t* count);
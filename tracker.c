@@ -2,6 +2,25 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+// byte counts of the trackers currently allocated, and the most ever
+// allocated at once, for memory accounting.
+static size_t live_bytes = 0;
+static size_t peak_bytes = 0;
+
+
+static void _count_tracker_bytes(long delta)
+{
+    live_bytes += delta;
+    if (live_bytes > peak_bytes)
+        peak_bytes = live_bytes;
+}
+
+
+size_t tracker_peak_bytes()
+{
+    return peak_bytes;
+}
+
 
 node* init_update_tracker()
 {
@@ -14,6 +33,7 @@ node* init_update_tracker()
 
     head->next = NULL;
     head->treenode = NULL;
+    _count_tracker_bytes(sizeof(node));
 
     return head;
 }
@@ -41,6 +61,7 @@ void track_update(node** updated_nodes, bstnode* tracked_node, int direction)
         new->treenode = tracked_node;
         new->next = *updated_nodes;
         new->direction = direction;
+        _count_tracker_bytes(sizeof(node));
 
         *updated_nodes = new;
     }
@@ -61,6 +82,7 @@ void destroy_update_tracker(node* update_tracker)
     while (current) {
         next = current->next;
         free(current);
+        _count_tracker_bytes(-(long) sizeof(node));
         current = next;
     }
 }
@@ -0,0 +1,96 @@
+/*
+ * treap.c
+ *
+ * An implementation of the randomized Treap
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "treap.h"
+
+
+bst* treap_create(void)
+{
+    return bst_create();
+}
+
+
+int treap_insert(bst* tree, bst_key value)
+{
+    bstnode* newnode = bst_create_node(tree, value);
+    TREAP_PRIORITY(newnode) = rand();
+
+    if (tree->length == 0) {
+        bst_node_insert(tree, newnode, NULL);
+        return 1;
+    }
+
+    node* path_tracker = init_update_tracker();
+    bstnode* insert_location = bst_find_node_and_path(tree, value, &path_tracker, 1);
+
+    if (insert_location) {
+        revert_rank_updates(path_tracker, -1);
+        destroy_update_tracker(path_tracker);
+        free(newnode);
+        return 0;
+    }
+
+    bst_node_insert(tree, newnode, path_tracker);
+    destroy_update_tracker(path_tracker);
+
+    // rotate the new node up until heap order is restored
+    while (newnode->parent && TREAP_PRIORITY(newnode->parent) < TREAP_PRIORITY(newnode)) {
+        int side = (newnode->parent->left == newnode) ? LEFT : RIGHT;
+        bst_rotate(tree, newnode->parent, REVERSE_DIRECTION(side));
+    }
+
+    return 1;
+}
+
+
+int treap_delete(bst* tree, bst_key value)
+{
+    bstnode* todelete = bst_search(tree, value);
+
+    if (!todelete) {
+        return 0;
+    }
+
+    // rotate the node down, lifting whichever child has the higher priority,
+    // until it can be snipped out directly. The ranks of the nodes rotated
+    // above it still count it, but bst_node_unlink takes care of that.
+    while (todelete->left && todelete->right) {
+        if (TREAP_PRIORITY(todelete->left) > TREAP_PRIORITY(todelete->right))
+            bst_rotate_right(tree, todelete);
+        else
+            bst_rotate_left(tree, todelete);
+    }
+
+    int direction;
+    bst_node_unlink(tree, todelete, &direction);
+    bst_free_node(tree, todelete);
+
+    return 1;
+}
+
+
+bstnode* treap_search(bst* tree, bst_key value)
+{
+    return bst_search(tree, value);
+}
+
+
+bstnode* treap_index(bst* tree, bst_size index)
+{
+    return bst_index(tree, index);
+}
+
+
+bst_size treap_get_index(bst* tree, bst_key value)
+{
+    return bst_get_index(tree, value);
+}
@@ -0,0 +1,29 @@
+/*
+ * treap.h
+ *
+ * An implementation of the randomized Treap, built on the same node and tree
+ * objects as the bst and avl modules. Each node is assigned a random
+ * priority (stored in its balance_factor field) when it is inserted, and the
+ * tree is kept in heap order with respect to these priorities, which keeps it
+ * balanced with high probability.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include "nodes.h"
+#include <assert.h>
+#include "bst.h"
+#include "tracker.h"
+
+#define TREAP_PRIORITY(node) ((node)->balance_factor)
+
+bst* treap_create(void);
+
+int treap_insert(bst* tree, bst_key value);
+int treap_delete(bst* tree, bst_key value);
+bstnode* treap_search(bst* tree, bst_key value);
+bstnode* treap_index(bst* tree, bst_size index);
+bst_size treap_get_index(bst* tree, bst_key value);
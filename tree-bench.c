@@ -0,0 +1,1011 @@
+/*
+ * tree-bench.c
+ * A simple benchmark comparing the balancing policies over a few different
+ * workloads, to help pick the right scheme for a given access pattern.
+ *
+ * Usage: tree-bench [workload] [n]
+ *      workload is one of uniform (default), sequential or skewed, which
+ *      compare the policies (and the unbalanced tree, other than for
+ *      sequential), reporting hardware counters per operation for each
+ *      phase where the kernel allows it (see perf.h). The searchmany
+ *      workload compares interleaved AVL searches (for each group size)
+ *      against one search at a time, which only pays off on trees much
+ *      larger than the LLC. The build workload compares n calls to
+ *      avl_insert against avl_build_parallel with increasing numbers of
+ *      threads (up to the number of cores). The executor workload runs a
+ *      batch of n mixed queries through avl_execute_queries with
+ *      increasing numbers of threads.
+ *      The wbuf workload compares n calls to avl_insert against inserting
+ *      through a write buffer, for a few buffer sizes. The hash workload
+ *      compares searches with and without the exact-match index, along
+ *      with the memory it takes. The quantile workload pushes n samples
+ *      through a sliding window, reading four quantiles after each, and
+ *      compares this against sorting a copy of the window at each step, for
+ *      a few window sizes. The savl workload compares the AVL tree against
+ *      the one without parent pointers, phase by phase. The compact
+ *      workload ages a tree with rounds of deletes and inserts, and times
+ *      in-order scans and searches over it before and after avl_compact.
+ *      The weighted workload compares weighted sampling from the tree
+ *      against an alias table, both with fixed weights and with batches of
+ *      weight updates between the samples, which the table can only absorb
+ *      by being rebuilt.
+ *      The seq workload edits a buffer of n elements at random positions,
+ *      and moves random ranges of it to the end, as a sequence and as an
+ *      array.
+ *      The paged workload loads the keys into the disk-resident tree (in
+ *      tree-bench.pages, in the working directory), and then times searches
+ *      and rank queries with the buffer pool at 100% down to 1% of the file,
+ *      along with the pages read per operation and the pool's hit rate.
+ *      The cache workload times skewed searches and rank queries with no
+ *      front cache and with caches of a few sizes, along with the hit rate
+ *      of each, and rank queries with an insert and a delete after every
+ *      hundred of them, which leave the cached ranks out of date.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "policy.h"
+#include "avl.h"
+#include "parallel.h"
+#include "wbuf.h"
+#include "quantile.h"
+#include "savl.h"
+#include "paged.h"
+#include "seq.h"
+#include "perf.h"
+
+
+double elapsed_ns(struct timespec* start, struct timespec* stop)
+{
+    return (stop->tv_sec - start->tv_sec) * 1e9 + (stop->tv_nsec - start->tv_nsec);
+}
+
+
+void report(const char* policy, const char* phase, double ns, int ops)
+{
+    printf("%-8s %-10s %10.1f ns/op %10.2f Mops/s\n", policy, phase, ns / ops,
+            ops / ns * 1e3);
+}
+
+
+// The unbalanced tree, as a baseline for the balancing policies. It isn't
+// one of balance_policies, as it isn't something anyone should pick.
+const balance_policy bst_bench_policy = {
+    .name = "bst",
+    .create = bst_create,
+    .insert = bst_insert,
+    .delete = bst_delete,
+    .search = bst_search,
+    .index = bst_index,
+    .get_index = bst_get_index,
+    .clear_destroy = bst_clear_destroy,
+};
+
+
+/*
+ * Generate the keys for the workload. The inserted keys are either a random
+ * permutation or ascending, and the searched keys are either uniform over the
+ * inserted ones, or skewed so that 90% of the searches hit 1% of the keys.
+ */
+void generate_workload(const char* workload, int* keys, int* queries, int n)
+{
+    for (int i=0; i<n; i++) {
+        keys[i] = i * 2;
+    }
+
+    if (strcmp(workload, "sequential")) {
+        for (int i=n-1; i>0; i--) {
+            int j = rand() % (i + 1);
+            int tmp = keys[i];
+            keys[i] = keys[j];
+            keys[j] = tmp;
+        }
+    }
+
+    int hot = (n / 100) ? n / 100 : 1;
+    for (int i=0; i<n; i++) {
+        if ((!strcmp(workload, "skewed") || !strcmp(workload, "cache")) && rand() % 10)
+            queries[i] = keys[rand() % hot];
+        else
+            queries[i] = keys[rand() % n];
+    }
+}
+
+
+void run_policy(const balance_policy* policy, int* keys, int* queries, int n,
+        perf_counters* counters)
+{
+    struct timespec start, stop;
+    volatile long sink = 0;
+
+    bst* tree = policy->create();
+
+    perf_start(counters);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        policy->insert(tree, keys[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    perf_stop(counters);
+    report(policy->name, "insert", elapsed_ns(&start, &stop), n);
+    perf_report(counters, n);
+
+    perf_start(counters);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        sink += (long) policy->search(tree, queries[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    perf_stop(counters);
+    report(policy->name, "search", elapsed_ns(&start, &stop), n);
+    perf_report(counters, n);
+
+    perf_start(counters);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        sink += (long) policy->index(tree, queries[i] / 2 + 1);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    perf_stop(counters);
+    report(policy->name, "index", elapsed_ns(&start, &stop), n);
+    perf_report(counters, n);
+
+    perf_start(counters);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        sink += policy->get_index(tree, queries[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    perf_stop(counters);
+    report(policy->name, "get_index", elapsed_ns(&start, &stop), n);
+    perf_report(counters, n);
+
+    perf_start(counters);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        policy->delete(tree, keys[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    perf_stop(counters);
+    report(policy->name, "delete", elapsed_ns(&start, &stop), n);
+    perf_report(counters, n);
+
+    policy->clear_destroy(tree);
+}
+
+
+void run_search_many(int* keys, int* queries, int n)
+{
+    struct timespec start, stop;
+    volatile long sink = 0;
+
+    bst* tree = avl_create();
+    for (int i=0; i<n; i++)
+        avl_insert(tree, keys[i]);
+
+    // the batch takes its keys as bst_key, which is wider under BST_64BIT
+    bstnode** found = malloc(sizeof(bstnode*) * n);
+    bst_key* batch = malloc(sizeof(bst_key) * n);
+    if (!found || !batch) {
+        fprintf(stderr, "Mallocation error in tree-bench.\n");
+        exit(-1);
+    }
+
+    for (int i=0; i<n; i++)
+        batch[i] = queries[i];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        sink += (long) avl_search(tree, queries[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("avl", "search", elapsed_ns(&start, &stop), n);
+
+    char phase[32];
+    for (int group=1; group<=BST_MAX_SEARCH_GROUP; group *= 2) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bst_search_many(tree, batch, n, found, group);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        snprintf(phase, sizeof(phase), "many/%d", group);
+        report("avl", phase, elapsed_ns(&start, &stop), n);
+    }
+
+    free(found);
+    free(batch);
+    avl_clear_destroy(tree);
+}
+
+
+void run_build(int* keys, int n)
+{
+    struct timespec start, stop;
+
+    bst* tree = avl_create();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        avl_insert(tree, keys[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("avl", "insert", elapsed_ns(&start, &stop), n);
+    avl_clear_destroy(tree);
+
+    // the build takes its keys as bst_key, which is wider under BST_64BIT
+    bst_key* wide = calloc(n, sizeof(bst_key));
+    if (!wide) {
+        fprintf(stderr, "Mallocation error in tree-bench.\n");
+        exit(-1);
+    }
+
+    for (int i=0; i<n; i++)
+        wide[i] = keys[i];
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    char phase[32];
+    for (int threads=1; threads<=cores && threads<=PARALLEL_MAX_THREADS; threads *= 2) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        tree = avl_build_parallel(wide, n, threads);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        snprintf(phase, sizeof(phase), "build/%d", threads);
+        report("avl", phase, elapsed_ns(&start, &stop), n);
+        avl_clear_destroy(tree);
+    }
+
+    free(wide);
+}
+
+
+void run_executor(int* keys, int* queries, int n)
+{
+    struct timespec start, stop;
+
+    bst_key* wide = calloc(n, sizeof(bst_key));
+    if (!wide) {
+        fprintf(stderr, "Mallocation error in tree-bench.\n");
+        exit(-1);
+    }
+
+    for (int i=0; i<n; i++)
+        wide[i] = keys[i];
+
+    bst* tree = avl_build_parallel(wide, n, 1);
+    free(wide);
+
+    tree_query* batch = malloc(sizeof(tree_query) * n);
+    query_result* results = malloc(sizeof(query_result) * n);
+    if (!batch || !results) {
+        fprintf(stderr, "Mallocation error in tree-bench.\n");
+        exit(-1);
+    }
+
+    for (int i=0; i<n; i++) {
+        batch[i].type = i % 4;
+        batch[i].arg = (batch[i].type == QUERY_INDEX) ? queries[i] / 2 + 1 : queries[i];
+        batch[i].arg2 = queries[i] + 1000;
+    }
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    char phase[32];
+    for (int threads=1; threads<=cores && threads<=PARALLEL_MAX_THREADS; threads *= 2) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        avl_execute_queries(tree, batch, n, results, threads);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        snprintf(phase, sizeof(phase), "queries/%d", threads);
+        report("avl", phase, elapsed_ns(&start, &stop), n);
+    }
+
+    free(batch);
+    free(results);
+    avl_clear_destroy(tree);
+}
+
+
+void run_write_buffer(int* keys, int* queries, int n)
+{
+    struct timespec start, stop;
+    volatile long sink = 0;
+
+    bst* tree = avl_create();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        avl_insert(tree, keys[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("avl", "insert", elapsed_ns(&start, &stop), n);
+    avl_clear_destroy(tree);
+
+    char phase[32];
+    for (int capacity=256; capacity<=65536; capacity *= 16) {
+        write_buffer* buffer = wbuf_create(capacity);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i=0; i<n; i++)
+            wbuf_insert(buffer, keys[i]);
+        wbuf_flush(buffer);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        snprintf(phase, sizeof(phase), "wbuf/%d", capacity);
+        report("avl", phase, elapsed_ns(&start, &stop), n);
+
+        // a read after each burst of writes has to resolve the log first,
+        // which costs more the larger the buffer is.
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i=0; i<n; i++) {
+            wbuf_insert(buffer, queries[i] + 1);
+            if (i % 64 == 0)
+                sink += wbuf_get_index(buffer, queries[i]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        snprintf(phase, sizeof(phase), "mixed/%d", capacity);
+        report("avl", phase, elapsed_ns(&start, &stop), n);
+
+        wbuf_clear_destroy(buffer);
+    }
+}
+
+
+void run_hash(int* keys, int* queries, int n)
+{
+    struct timespec start, stop;
+    volatile long sink = 0;
+    avl_stats stats;
+
+    bst* tree = avl_create();
+    for (int i=0; i<n; i++)
+        avl_insert(tree, keys[i]);
+
+    const char* phases[] = {"search", "hashed"};
+    for (int hashed=0; hashed<2; hashed++) {
+        if (hashed)
+            avl_enable_hash(tree);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i=0; i<n; i++)
+            sink += (long) avl_search(tree, queries[i]);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        report("avl", phases[hashed], elapsed_ns(&start, &stop), n);
+
+        // half of these miss
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i=0; i<n; i++)
+            sink += (long) avl_search(tree, queries[i] + (i & 1));
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        report("avl", (hashed) ? "hashed/50%" : "search/50%", elapsed_ns(&start, &stop), n);
+    }
+
+    avl_memory_stats(tree, &stats, 0);
+    printf("node bytes: %zu, index bytes: %zu (%.1f per node)\n", stats.node_bytes,
+            stats.index_bytes, (double) stats.index_bytes / stats.nodes);
+
+    avl_clear_destroy(tree);
+}
+
+
+static double time_cache_phase(bst* tree, int* queries, int n, int ranks, int updates)
+{
+    // one pass of searches (or rank queries) over queries, with a pair of
+    // updates every 100 of them if updates is set. Returns the time taken.
+    struct timespec start, stop;
+    volatile long sink = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++) {
+        if (ranks)
+            sink += avl_get_index(tree, queries[i]);
+        else
+            sink += (long) avl_search(tree, queries[i]);
+
+        // odd keys aren't in the tree, so this leaves it as it was
+        if (updates && i % 100 == 0) {
+            avl_insert(tree, queries[i] + 1);
+            avl_delete(tree, queries[i] + 1);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+
+    return elapsed_ns(&start, &stop);
+}
+
+
+void run_cache(int* keys, int* queries, int n)
+{
+    char name[32];
+    avl_stats stats;
+
+    bst* tree = avl_create();
+    for (int i=0; i<n; i++)
+        avl_insert(tree, keys[i]);
+
+    report("avl", "search", time_cache_phase(tree, queries, n, 0, 0), n);
+    report("avl", "rank", time_cache_phase(tree, queries, n, 1, 0), n);
+    report("avl", "rank+upd", time_cache_phase(tree, queries, n, 1, 1), n);
+
+    // a quarter of the hot keys, all of them, and four times as many
+    size_t sizes[] = {n / 400 + 1, n / 100 + 1, n / 25 + 1};
+    for (int s=0; s<3; s++) {
+        avl_enable_cache(tree, sizes[s]);
+        snprintf(name, sizeof(name), "cache/%zu", sizes[s]);
+
+        // a first pass to warm the cache up, which isn't reported
+        time_cache_phase(tree, queries, n, 0, 0);
+
+        tree->cache->hits = tree->cache->misses = 0;
+        report(name, "search", time_cache_phase(tree, queries, n, 0, 0), n);
+        double search_hits = bst_cache_hit_rate(tree->cache);
+
+        tree->cache->hits = tree->cache->misses = 0;
+        report(name, "rank", time_cache_phase(tree, queries, n, 1, 0), n);
+        double rank_hits = bst_cache_hit_rate(tree->cache);
+
+        tree->cache->hits = tree->cache->misses = 0;
+        report(name, "rank+upd", time_cache_phase(tree, queries, n, 1, 1), n);
+
+        avl_memory_stats(tree, &stats, 0);
+        printf("%s: hit rate %.1f%% (search), %.1f%% (rank), %.1f%% (rank+upd), %zu bytes\n",
+                name, 100 * search_hits, 100 * rank_hits,
+                100 * bst_cache_hit_rate(tree->cache), stats.cache_bytes);
+    }
+
+    avl_clear_destroy(tree);
+}
+
+
+static size_t malloc_chunk(size_t size)
+{
+    // the chunk glibc's malloc uses for a request of size bytes
+    size_t chunk = (size + sizeof(size_t) + 15) & ~(size_t) 15;
+    return (chunk < 32) ? 32 : chunk;
+}
+
+
+void run_savl(int* keys, int* queries, int n, perf_counters* counters)
+{
+    struct timespec start, stop;
+    volatile long sink = 0;
+
+    printf("node bytes: avl %zu (%zu allocated), savl %zu (%zu allocated)\n",
+            sizeof(bstnode), malloc_chunk(sizeof(bstnode)), sizeof(savlnode),
+            malloc_chunk(sizeof(savlnode)));
+
+    run_policy(&avl_policy, keys, queries, n, counters);
+
+    savl* tree = savl_create();
+
+    perf_start(counters);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        savl_insert(tree, keys[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    perf_stop(counters);
+    report("savl", "insert", elapsed_ns(&start, &stop), n);
+    perf_report(counters, n);
+
+    perf_start(counters);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        sink += (long) savl_search(tree, queries[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    perf_stop(counters);
+    report("savl", "search", elapsed_ns(&start, &stop), n);
+    perf_report(counters, n);
+
+    perf_start(counters);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        sink += (long) savl_index(tree, queries[i] / 2 + 1);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    perf_stop(counters);
+    report("savl", "index", elapsed_ns(&start, &stop), n);
+    perf_report(counters, n);
+
+    perf_start(counters);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        sink += savl_get_index(tree, queries[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    perf_stop(counters);
+    report("savl", "get_index", elapsed_ns(&start, &stop), n);
+    perf_report(counters, n);
+
+    perf_start(counters);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        savl_delete(tree, keys[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    perf_stop(counters);
+    report("savl", "delete", elapsed_ns(&start, &stop), n);
+    perf_report(counters, n);
+
+    savl_clear_destroy(tree);
+}
+
+
+static void time_scans_and_searches(bst* tree, int* queries, int n, const char* when)
+{
+    struct timespec start, stop;
+    volatile long sink = 0;
+    char phase[32];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int pass=0; pass<4; pass++) {
+        for (bstnode* node = bst_node_min(tree->head); node; node = avl_next(node))
+            sink += node->value;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    snprintf(phase, sizeof(phase), "scan/%s", when);
+    report("avl", phase, elapsed_ns(&start, &stop), 4 * tree->length);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        sink += (long) avl_search(tree, queries[i]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    snprintf(phase, sizeof(phase), "search/%s", when);
+    report("avl", phase, elapsed_ns(&start, &stop), n);
+}
+
+
+void run_compact(int* keys, int* queries, int n)
+{
+    struct timespec start, stop;
+
+    // Age the tree: each round deletes a random quarter of the keys and
+    // inserts them again, so the allocator hands the nodes back out in an
+    // order that has nothing to do with their keys.
+    bst* tree = avl_create();
+    for (int i=0; i<n; i++)
+        avl_insert(tree, keys[i]);
+
+    for (int round=0; round<8; round++) {
+        int start_at = rand() % n;
+        for (int i=0; i<n/4; i++)
+            avl_delete(tree, keys[(start_at + i * 7919L) % n]);
+        for (int i=0; i<n/4; i++)
+            avl_insert(tree, keys[(start_at + i * 7919L) % n]);
+    }
+
+    time_scans_and_searches(tree, queries, n, "aged");
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    avl_compact(tree);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("avl", "compact", elapsed_ns(&start, &stop), tree->length);
+
+    time_scans_and_searches(tree, queries, n, "compact");
+
+    // and with the work spread over many small steps
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int steps = 0;
+    while (avl_compact_incremental(tree, 64))
+        steps++;
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("avl", "step/64", elapsed_ns(&start, &stop), steps + 1);
+
+    avl_clear_destroy(tree);
+}
+
+
+static void build_alias_table(const long long* weights, int n, double* prob, int* alias, int* work)
+{
+    // Vose's alias method: each slot keeps its own key with probability
+    // prob[i], and otherwise gives alias[i]. Slots are split into a stack of
+    // underfull ones (from the bottom of work) and overfull ones (from the
+    // top), and each underfull slot is topped up from an overfull one.
+    long long total = 0;
+    for (int i=0; i<n; i++)
+        total += weights[i];
+
+    int small = 0, large = n;
+    for (int i=0; i<n; i++) {
+        prob[i] = (double) weights[i] * n / total;
+        if (prob[i] < 1)
+            work[small++] = i;
+        else
+            work[--large] = i;
+    }
+
+    while (small && large < n) {
+        int under = work[--small];
+        int over = work[large];
+
+        alias[under] = over;
+        prob[over] -= 1 - prob[under];
+        if (prob[over] < 1) {
+            large++;
+            work[small++] = over;
+        }
+    }
+
+    // anything left over is full, up to rounding
+    while (small) prob[work[--small]] = 1;
+    while (large < n) prob[work[large++]] = 1;
+}
+
+
+void run_weighted(int* keys, int n)
+{
+    struct timespec start, stop;
+    volatile long sink = 0;
+    avl_rng rng;
+    avl_rng_seed(&rng, 12345);
+
+    long long* weights = malloc(sizeof(long long) * n);
+    double* prob = malloc(sizeof(double) * n);
+    int* alias = malloc(sizeof(int) * n);
+    int* work = malloc(sizeof(int) * n);
+    if (!weights || !prob || !alias || !work) {
+        fprintf(stderr, "Mallocation error in tree-bench.\n");
+        exit(-1);
+    }
+
+    // keys[i] is 2i after shuffling, so weights are indexed by key / 2
+    for (int i=0; i<n; i++)
+        weights[i] = rand() % 1000 + 1;
+
+    bst* tree = avl_create_weighted();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        avl_insert_payload(tree, keys[i], weights[keys[i] / 2]);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("avl", "build", elapsed_ns(&start, &stop), n);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    build_alias_table(weights, n, prob, alias, work);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("alias", "build", elapsed_ns(&start, &stop), n);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        sink += avl_sample_weighted(tree, &rng)->value;
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("avl", "sample", elapsed_ns(&start, &stop), n);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++) {
+        uint64_t r = avl_rng_next(&rng);
+        int slot = (int) (((r >> 32) * n) >> 32);
+        sink += ((r & 0xffffffff) < prob[slot] * 4294967296.0) ? slot : alias[slot];
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("alias", "sample", elapsed_ns(&start, &stop), n);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        sink += avl_sample(tree, &rng)->value;
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("avl", "uniform", elapsed_ns(&start, &stop), n);
+
+    // Weights changing under a stream of samples: the tree updates each in
+    // place, while the table has to be rebuilt before the next sample, for
+    // a batch of updates at a time.
+    char phase[32];
+    int samples = n / 10;
+    for (int batch=1; batch<=n / 10; batch *= 100) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i=0; i<samples; i++) {
+            if (i % batch == 0) {
+                for (int j=0; j<batch; j++) {
+                    int k = rand() % n;
+                    weights[k] = rand() % 1000 + 1;
+                    bst_set_payload(tree, avl_search(tree, 2 * k), weights[k]);
+                }
+            }
+            sink += avl_sample_weighted(tree, &rng)->value;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        snprintf(phase, sizeof(phase), "mixed/%d", batch);
+        report("avl", phase, elapsed_ns(&start, &stop), samples);
+
+        // the table is rebuilt far too slowly to run every sample, so only
+        // enough for a few rebuilds are timed
+        int alias_samples = (samples < 20 * batch) ? samples : 20 * batch;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i=0; i<alias_samples; i++) {
+            if (i % batch == 0) {
+                for (int j=0; j<batch; j++)
+                    weights[rand() % n] = rand() % 1000 + 1;
+                build_alias_table(weights, n, prob, alias, work);
+            }
+            uint64_t r = avl_rng_next(&rng);
+            int slot = (int) (((r >> 32) * n) >> 32);
+            sink += ((r & 0xffffffff) < prob[slot] * 4294967296.0) ? slot : alias[slot];
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        report("alias", phase, elapsed_ns(&start, &stop), alias_samples);
+    }
+
+    avl_clear_destroy(tree);
+    free(weights);
+    free(prob);
+    free(alias);
+    free(work);
+}
+
+
+void run_seq(int* queries, int n)
+{
+    struct timespec start, stop;
+    volatile long sink = 0;
+
+    // a buffer of n elements, edited at random positions: k inserts each
+    // followed by a delete, and k moves of a random range to the end
+    int k = (n / 100) ? n / 100 : 1;
+    int* array = malloc(sizeof(int) * (n + 1));
+    int* scratch = malloc(sizeof(int) * n);
+    if (!array || !scratch) {
+        fprintf(stderr, "Mallocation error in tree-bench.\n");
+        exit(-1);
+    }
+
+    bst* seq = seq_create();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        seq_append(seq, i);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("seq", "append", elapsed_ns(&start, &stop), n);
+
+    for (int i=0; i<n; i++)
+        array[i] = i;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<k; i++) {
+        int at = queries[i] % n;
+        memmove(array + at + 1, array + at, sizeof(int) * (n - at));
+        array[at] = -i;
+        at = queries[k + i] % n;
+        memmove(array + at, array + at + 1, sizeof(int) * (n - at));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("array", "edit", elapsed_ns(&start, &stop), 2 * k);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<k; i++) {
+        seq_insert_at(seq, queries[i] % n + 1, -i);
+        seq_delete_at(seq, queries[k + i] % n + 1, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("seq", "edit", elapsed_ns(&start, &stop), 2 * k);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        sink += array[queries[i] % n];
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("array", "get", elapsed_ns(&start, &stop), n);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        sink += seq_get(seq, queries[i] % n + 1)->value;
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("seq", "get", elapsed_ns(&start, &stop), n);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<k; i++) {
+        int from = queries[i] % n;
+        int count = queries[k + i] % (n - from);
+        memcpy(scratch, array + from, sizeof(int) * count);
+        memmove(array + from, array + from + count, sizeof(int) * (n - from - count));
+        memcpy(array + n - count, scratch, sizeof(int) * count);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("array", "move", elapsed_ns(&start, &stop), k);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<k; i++) {
+        int from = queries[i] % n;
+        int count = queries[k + i] % (n - from);
+        bst* middle = seq_split(seq, from);
+        bst* end = seq_split(middle, count);
+        seq_concat(seq, end);
+        seq_concat(seq, middle);
+        avl_destroy(middle);
+        avl_destroy(end);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report("seq", "move", elapsed_ns(&start, &stop), k);
+
+    avl_clear_destroy(seq);
+    free(array);
+    free(scratch);
+}
+
+
+static void report_io(const char* phase, double ns, int ops, paged_tree* tree)
+{
+    printf("%-8s %-10s %10.1f ns/op %10.2f Mops/s %8.3f reads/op %6.1f%% hits\n", "paged",
+            phase, ns / ops, ops / ns * 1e3, (double) tree->io.reads / ops,
+            100 * paged_hit_rate(tree));
+}
+
+
+void run_paged(int* keys, int* queries, int n)
+{
+    struct timespec start, stop;
+    volatile long sink = 0;
+    const char* path = "tree-bench.pages";
+
+    remove(path);
+    paged_tree* tree = paged_open(path, n / 256);
+    if (!tree) {
+        fprintf(stderr, "Unable to create %s\n", path);
+        exit(-1);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i=0; i<n; i++)
+        paged_insert(tree, keys[i]);
+    paged_flush(tree);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    report_io("insert", elapsed_ns(&start, &stop), n, tree);
+
+    int data_pages = tree->header.page_count;
+    printf("%d keys in %d pages of %d bytes\n", n, data_pages, PAGED_PAGE_SIZE);
+
+    // The same searches with the pool at a shrinking fraction of the file.
+    // The file is dropped from the kernel's page cache first, so the reads
+    // really go to the disk, at least the first time.
+    char phase[32];
+    int percents[] = {100, 50, 25, 10, 5, 1};
+    for (int p=0; p<6; p++) {
+        paged_set_pool(tree, (long) data_pages * percents[p] / 100);
+        posix_fadvise(tree->fd, 0, 0, POSIX_FADV_DONTNEED);
+        paged_reset_io(tree);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i=0; i<n; i++)
+            sink += paged_search(tree, queries[i]);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        snprintf(phase, sizeof(phase), "search/%d%%", percents[p]);
+        report_io(phase, elapsed_ns(&start, &stop), n, tree);
+
+        paged_reset_io(tree);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i=0; i<n; i++)
+            sink += paged_get_index(tree, queries[i]);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        snprintf(phase, sizeof(phase), "rank/%d%%", percents[p]);
+        report_io(phase, elapsed_ns(&start, &stop), n, tree);
+    }
+
+    paged_close(tree);
+    remove(path);
+}
+
+
+static int compare_ints(const void* a, const void* b)
+{
+    int x = *(const int*) a;
+    int y = *(const int*) b;
+
+    return (x > y) - (x < y);
+}
+
+
+void run_quantile(int* keys, int n)
+{
+    static const double qs[] = {0.5, 0.9, 0.99, 0.999};
+    int k = sizeof(qs) / sizeof(qs[0]);
+
+    struct timespec start, stop;
+    volatile long sink = 0;
+    char phase[32];
+    int out[sizeof(qs) / sizeof(qs[0])];
+
+    // latency-like samples, with plenty of duplicates
+    int* samples = malloc(sizeof(int) * n);
+    int* sorted = malloc(sizeof(int) * n);
+    if (!samples || !sorted) {
+        fprintf(stderr, "Mallocation error in tree-bench.\n");
+        exit(-1);
+    }
+
+    for (int i=0; i<n; i++)
+        samples[i] = keys[i] % 10000;
+
+    for (int size=1000; size<=n && size<=1000000; size *= 10) {
+        quantile_window* window = quantile_create(size);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i=0; i<n; i++) {
+            quantile_push(window, samples[i]);
+            quantile_get_many(window, qs, k, out);
+            sink += out[0];
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        snprintf(phase, sizeof(phase), "window/%d", size);
+        report("avl", phase, elapsed_ns(&start, &stop), n);
+        quantile_destroy(window);
+
+        // sorting the whole window each step is far slower, so only time
+        // enough full windows to get a stable figure
+        int steps = (int) (1e8 / size);
+        if (steps > n - size) steps = n - size;
+        if (steps < 1) continue;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i=0; i<steps; i++) {
+            memcpy(sorted, samples + i + 1, sizeof(int) * size);
+            qsort(sorted, size, sizeof(int), compare_ints);
+            for (int j=0; j<k; j++)
+                sink += sorted[(int) (qs[j] * (size - 1))];
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        snprintf(phase, sizeof(phase), "resort/%d", size);
+        report("qsort", phase, elapsed_ns(&start, &stop), steps);
+    }
+
+    free(samples);
+    free(sorted);
+}
+
+
+int main(int argc, char **argv)
+{
+    const char* workload = (argc > 1) ? argv[1] : "uniform";
+    int n = (argc > 2) ? atoi(argv[2]) : 1000000;
+
+    int* keys = malloc(sizeof(int) * n);
+    int* queries = malloc(sizeof(int) * n);
+    if (!keys || !queries) {
+        fprintf(stderr, "Mallocation error in tree-bench.\n");
+        exit(-1);
+    }
+
+    srand(12345);
+    generate_workload(workload, keys, queries, n);
+
+    printf("workload: %s, n = %d\n", workload, n);
+    if (!strcmp(workload, "searchmany")) {
+        run_search_many(keys, queries, n);
+    } else if (!strcmp(workload, "build")) {
+        run_build(keys, n);
+    } else if (!strcmp(workload, "executor")) {
+        run_executor(keys, queries, n);
+    } else if (!strcmp(workload, "wbuf")) {
+        run_write_buffer(keys, queries, n);
+    } else if (!strcmp(workload, "hash")) {
+        run_hash(keys, queries, n);
+    } else if (!strcmp(workload, "compact")) {
+        run_compact(keys, queries, n);
+    } else if (!strcmp(workload, "quantile")) {
+        run_quantile(keys, n);
+    } else if (!strcmp(workload, "weighted")) {
+        run_weighted(keys, n);
+    } else if (!strcmp(workload, "seq")) {
+        run_seq(queries, n);
+    } else if (!strcmp(workload, "paged")) {
+        run_paged(keys, queries, n);
+    } else if (!strcmp(workload, "cache")) {
+        run_cache(keys, queries, n);
+    } else {
+        perf_counters counters;
+        perf_open(&counters);
+        if (counters.available < PERF_EVENTS)
+            printf("%d of %d hardware counters available (%s)\n", counters.available,
+                    PERF_EVENTS, strerror(counters.error));
+
+        if (!strcmp(workload, "savl")) {
+            run_savl(keys, queries, n, &counters);
+        } else {
+            // the unbalanced tree would take quadratic time on sorted keys
+            if (strcmp(workload, "sequential"))
+                run_policy(&bst_bench_policy, keys, queries, n, &counters);
+
+            for (int i=0; balance_policies[i]; i++) {
+                run_policy(balance_policies[i], keys, queries, n, &counters);
+            }
+        }
+
+        perf_close(&counters);
+    }
+
+    free(keys);
+    free(queries);
+    return 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * tree-client.c
+ * A load generator for tree-server. It fills the server's tree, checks a
+ * sample of the answers, and then sends a mixed workload in pipelined
+ * batches, reporting the throughput and the distribution of batch round-trip
+ * times.
+ *
+ * Usage: tree-client [socket path] [n] [batch size]
+ *      n keys are inserted (and n mixed requests sent afterwards), in
+ *      batches of up to PROTO_MAX_BATCH requests. The mix is 70% search,
+ *      10% index, 10% get_index, 5% range count, and 5% split between
+ *      inserts and deletes.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "tree-proto.h"
+
+
+static int _connect(const char* path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    if (fd < 0 || connect(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+        perror("connect");
+        exit(-1);
+    }
+
+    return fd;
+}
+
+
+static void _transfer(int fd, void* data, size_t size, int writing)
+{
+    char* bytes = data;
+    while (size) {
+        ssize_t done = (writing) ? write(fd, bytes, size) : read(fd, bytes, size);
+        if (done < 0 && errno == EINTR) continue;
+        if (done <= 0) {
+            fprintf(stderr, "Connection to tree-server lost.\n");
+            exit(-1);
+        }
+
+        bytes += done;
+        size -= done;
+    }
+}
+
+
+static void _round_trip(int fd, proto_request* requests, proto_response* responses, int count)
+{
+    // one write for the whole batch, and then as few reads as the socket
+    // allows for the responses
+    _transfer(fd, requests, sizeof(proto_request) * count, 1);
+    _transfer(fd, responses, sizeof(proto_response) * count, 0);
+}
+
+
+static double _elapsed_ns(struct timespec* start, struct timespec* stop)
+{
+    return (stop->tv_sec - start->tv_sec) * 1e9 + (stop->tv_nsec - start->tv_nsec);
+}
+
+
+static int _compare_doubles(const void* a, const void* b)
+{
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+
+    return (x > y) - (x < y);
+}
+
+
+static void _random_request(proto_request* request, int n)
+{
+    int roll = rand() % 100;
+    int key = rand() % (2 * n);
+
+    request->arg = key;
+    request->arg2 = key + 100;
+
+    if (roll < 70) {
+        request->op = PROTO_SEARCH;
+    } else if (roll < 80) {
+        request->op = PROTO_INDEX;
+        request->arg = rand() % n + 1;
+    } else if (roll < 90) {
+        request->op = PROTO_GET_INDEX;
+    } else if (roll < 95) {
+        request->op = PROTO_RANGE_COUNT;
+    } else {
+        // even keys were loaded, so this keeps the size roughly stable
+        request->op = (key & 1) ? PROTO_INSERT : PROTO_DELETE;
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+    const char* path = (argc > 1) ? argv[1] : PROTO_DEFAULT_SOCKET;
+    int n = (argc > 2) ? atoi(argv[2]) : 1000000;
+    int batch = (argc > 3) ? atoi(argv[3]) : 256;
+
+    if (batch < 1) batch = 1;
+    if (batch > PROTO_MAX_BATCH) batch = PROTO_MAX_BATCH;
+
+    proto_request* requests = malloc(sizeof(proto_request) * batch);
+    proto_response* responses = malloc(sizeof(proto_response) * batch);
+    int batches = (n + batch - 1) / batch;
+    double* latencies = malloc(sizeof(double) * batches);
+    if (!requests || !responses || !latencies) {
+        fprintf(stderr, "Mallocation error in tree-client.\n");
+        exit(-1);
+    }
+
+    int fd = _connect(path);
+    srand(time(NULL));
+
+    // load the even keys below 2n, in a random order
+    int* keys = malloc(sizeof(int) * n);
+    if (!keys) {
+        fprintf(stderr, "Mallocation error in tree-client.\n");
+        exit(-1);
+    }
+
+    for (int i=0; i<n; i++)
+        keys[i] = 2 * i;
+    for (int i=n-1; i>0; i--) {
+        int j = rand() % (i + 1);
+        int tmp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+
+    struct timespec start, stop;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int done=0; done<n; done+=batch) {
+        int count = (n - done < batch) ? n - done : batch;
+        for (int i=0; i<count; i++)
+            requests[i] = (proto_request) {PROTO_INSERT, keys[done + i], 0};
+
+        _round_trip(fd, requests, responses, count);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    printf("loaded %d keys in %.2f s\n", n, _elapsed_ns(&start, &stop) / 1e9);
+
+    // The server may already have held other keys, so only check the
+    // answers against each other.
+    int count = (batch < 64) ? batch : 64;
+    for (int i=0; i<count; i++)
+        requests[i] = (proto_request) {PROTO_GET_INDEX, keys[i], 0};
+    _round_trip(fd, requests, responses, count);
+
+    for (int i=0; i<count; i++) {
+        assert(responses[i].value >= 1);
+        requests[i] = (proto_request) {PROTO_INDEX, responses[i].value, 0};
+    }
+    _round_trip(fd, requests, responses, count);
+
+    for (int i=0; i<count; i++)
+        assert(responses[i].status == 1 && responses[i].value == keys[i]);
+    printf("answers check out\n");
+
+    // and the mixed workload, timing each batch
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int b=0; b<batches; b++) {
+        int count = (b == batches - 1) ? n - b * batch : batch;
+        for (int i=0; i<count; i++)
+            _random_request(&requests[i], n);
+
+        struct timespec sent, received;
+        clock_gettime(CLOCK_MONOTONIC, &sent);
+        _round_trip(fd, requests, responses, count);
+        clock_gettime(CLOCK_MONOTONIC, &received);
+
+        latencies[b] = _elapsed_ns(&sent, &received);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+
+    double total = _elapsed_ns(&start, &stop);
+    qsort(latencies, batches, sizeof(double), _compare_doubles);
+
+    printf("%d requests in batches of %d: %.2f Mops/s\n", n, batch, n / total * 1e3);
+    printf("batch round trip (us): p50 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+            latencies[batches / 2] / 1e3, latencies[(int) (batches * 0.99)] / 1e3,
+            latencies[(int) (batches * 0.999)] / 1e3, latencies[batches - 1] / 1e3);
+
+    close(fd);
+    free(keys);
+    free(requests);
+    free(responses);
+    free(latencies);
+    return 0;
+}
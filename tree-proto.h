@@ -0,0 +1,50 @@
+/*
+ * tree-proto.h
+ *
+ * The binary protocol spoken by tree-server over a Unix domain socket. Both
+ * ends are on the same machine, so records are fixed-size structs in native
+ * byte order, with no framing beyond their size.
+ *
+ * A client may write any number of requests before reading, and the server
+ * executes them back to back in the order they arrive, writing one response
+ * per request in the same order. Batching requests this way amortizes the
+ * syscalls on both sides over the whole batch.
+ *
+ * Keys, indexes and counts are 64 bits wide on the wire, whatever the width
+ * of the server's keys (see nodes.h), so clients needn't know how it was
+ * built. A server with 32 bit keys answers requests whose arguments don't
+ * fit in them with a status of -1.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include "parallel.h"
+
+#define PROTO_DEFAULT_SOCKET "/tmp/tree-server.sock"
+
+// the read-only requests share their codes with the query executor
+#define PROTO_SEARCH QUERY_SEARCH            // status 1 and value = arg if present
+#define PROTO_INDEX QUERY_INDEX              // status 1 and the key at index arg
+#define PROTO_GET_INDEX QUERY_GET_INDEX      // value is the index of arg, or -1
+#define PROTO_RANGE_COUNT QUERY_RANGE_COUNT  // value is the number of keys in [arg, arg2]
+#define PROTO_INSERT 4                       // status 1 if arg was inserted
+#define PROTO_DELETE 5                       // status 1 if arg was deleted
+
+// the most requests a client should have in flight at once, so that neither
+// side can fill the socket buffers while the other is blocked writing
+#define PROTO_MAX_BATCH 4096
+
+typedef struct ProtoRequest {
+    int32_t op;
+    int64_t arg;
+    int64_t arg2;
+} proto_request;
+
+typedef struct ProtoResponse {
+    int32_t status;
+    int64_t value;
+} proto_response;
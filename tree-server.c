@@ -0,0 +1,303 @@
+/*
+ * tree-server.c
+ * A small daemon that owns one AVL tree and serves requests for it over a
+ * Unix domain socket (see tree-proto.h), so that several processes can share
+ * a single copy of a large tree.
+ *
+ * Usage: tree-server [socket path]
+ *      If TREE_TRACE is set in the environment, every operation the server
+ *      executes is recorded to the trace file it names, for trace-replay.
+ *
+ * Everything runs on one thread, driven by an epoll loop over non-blocking
+ * sockets, so requests from all clients are serialized and need no locking.
+ * Each time a client is readable, every complete request in its buffer is
+ * executed, and the responses for the whole lot go out in one write. While a
+ * client's responses can't be written, it isn't read from either, so a slow
+ * reader can't make the server buffer without bound.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+
+#include "avl.h"
+#include "tree-proto.h"
+
+#define SERVER_MAX_EVENTS 64
+
+// bytes of requests read from a client at a time
+#define SERVER_BUFFER (sizeof(proto_request) * 8192)
+
+typedef struct Client {
+    int fd;
+
+    // requests read but not yet executed (at most one partial one)
+    char in[SERVER_BUFFER];
+    size_t in_len;
+
+    // responses not yet written
+    char out[SERVER_BUFFER];
+    size_t out_len;
+    size_t out_sent;
+
+    // whether we're waiting for the socket to drain, rather than for input
+    int draining;
+} client;
+
+
+static volatile sig_atomic_t stopping = 0;
+
+
+static void _handle_signal(int signal)
+{
+    (void) signal;
+    stopping = 1;
+}
+
+
+static void _execute(bst* tree, const proto_request* request, proto_response* response)
+{
+    tree_query query = {request->op, request->arg, request->arg2};
+    query_result result;
+
+    response->status = 0;
+    response->value = 0;
+
+    if (request->arg < BST_KEY_MIN || request->arg > BST_KEY_MAX
+            || request->arg2 < BST_KEY_MIN || request->arg2 > BST_KEY_MAX) {
+        response->status = -1;
+        return;
+    }
+
+    // the point queries go through the avl_ functions, rather than
+    // avl_execute_query, so that they are traced along with the writes
+    bstnode* found = NULL;
+
+    switch (request->op) {
+        case PROTO_SEARCH:
+        case PROTO_INDEX:
+            found = (request->op == PROTO_SEARCH) ? avl_search(tree, request->arg)
+                : avl_index(tree, request->arg);
+            if (found) {
+                response->status = 1;
+                response->value = found->value;
+            }
+            break;
+        case PROTO_GET_INDEX:
+            response->status = 1;
+            response->value = avl_get_index(tree, request->arg);
+            break;
+        case PROTO_RANGE_COUNT:
+            avl_execute_query(tree, &query, &result);
+            response->status = 1;
+            response->value = result.count;
+            break;
+        case PROTO_INSERT:
+            response->status = avl_insert(tree, request->arg);
+            break;
+        case PROTO_DELETE:
+            response->status = avl_delete(tree, request->arg);
+            break;
+        default:
+            // unknown requests still get a response, to keep the stream
+            // in step
+            response->status = -1;
+    }
+}
+
+
+static void _set_draining(int epoll_fd, client* c, int draining)
+{
+    // only costs a syscall when the client switches between the two
+    if (c->draining == draining) return;
+
+    struct epoll_event event = {.events = (draining) ? EPOLLOUT : EPOLLIN, .data.ptr = c};
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c->fd, &event);
+    c->draining = draining;
+}
+
+
+static void _close_client(int epoll_fd, client* c)
+{
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    free(c);
+}
+
+
+static int _flush_client(int epoll_fd, client* c)
+{
+    // Returns 0 if the client had to be closed. Otherwise, the client is
+    // left waiting for input if everything was written, or for the socket to
+    // drain if not.
+    while (c->out_sent < c->out_len) {
+        ssize_t written = write(c->fd, c->out + c->out_sent, c->out_len - c->out_sent);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                _set_draining(epoll_fd, c, 1);
+                return 1;
+            }
+
+            _close_client(epoll_fd, c);
+            return 0;
+        }
+
+        c->out_sent += written;
+    }
+
+    c->out_len = c->out_sent = 0;
+    _set_draining(epoll_fd, c, 0);
+    return 1;
+}
+
+
+static void _serve_client(int epoll_fd, bst* tree, client* c)
+{
+    for (;;) {
+        ssize_t got = read(c->fd, c->in + c->in_len, SERVER_BUFFER - c->in_len);
+        if (got < 0 && errno == EINTR) continue;
+        if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        if (got <= 0) {
+            _close_client(epoll_fd, c);
+            return;
+        }
+
+        c->in_len += got;
+
+        // every complete request is executed, back to back
+        size_t count = c->in_len / sizeof(proto_request);
+        proto_request* requests = (proto_request*) c->in;
+        proto_response* responses = (proto_response*) c->out;
+        for (size_t i=0; i<count; i++)
+            _execute(tree, &requests[i], &responses[i]);
+
+        c->out_len = count * sizeof(proto_response);
+        c->out_sent = 0;
+
+        size_t used = count * sizeof(proto_request);
+        memmove(c->in, c->in + used, c->in_len - used);
+        c->in_len -= used;
+
+        if (!_flush_client(epoll_fd, c) || c->out_len) return;
+    }
+}
+
+
+static int _listen(const char* path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        perror("socket");
+        exit(-1);
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path too long: %s\n", path);
+        exit(-1);
+    }
+    strcpy(addr.sun_path, path);
+
+    unlink(path);
+    if (bind(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0 || listen(fd, 64) < 0) {
+        perror("bind");
+        exit(-1);
+    }
+
+    return fd;
+}
+
+
+static void _accept_clients(int epoll_fd, int listen_fd)
+{
+    for (;;) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK);
+        if (fd < 0) return;
+
+        client* c = malloc(sizeof(client));
+        if (!c) {
+            fprintf(stderr, "Mallocation error in tree-server.\n");
+            exit(-1);
+        }
+
+        c->fd = fd;
+        c->in_len = c->out_len = c->out_sent = 0;
+        c->draining = 0;
+
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = c};
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+    const char* path = (argc > 1) ? argv[1] : PROTO_DEFAULT_SOCKET;
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = _handle_signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    int listen_fd = _listen(path);
+    int epoll_fd = epoll_create1(0);
+
+    // the listening socket is told apart from the clients by a NULL pointer
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = NULL};
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+
+    bst* tree = avl_create();
+
+    const char* trace_path = getenv("TREE_TRACE");
+    if (trace_path && !avl_start_trace(tree, trace_path)) {
+        fprintf(stderr, "Unable to create trace: %s\n", trace_path);
+        exit(-1);
+    }
+
+    printf("serving on %s\n", path);
+    fflush(stdout);
+
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    while (!stopping) {
+        int ready = epoll_wait(epoll_fd, events, SERVER_MAX_EVENTS, -1);
+
+        for (int i=0; i<ready; i++) {
+            client* c = events[i].data.ptr;
+
+            if (!c)
+                _accept_clients(epoll_fd, listen_fd);
+            else if (events[i].events & EPOLLOUT) {
+                // once the backlog drains, pick up any requests that
+                // arrived in the meantime
+                if (_flush_client(epoll_fd, c) && !c->out_len)
+                    _serve_client(epoll_fd, tree, c);
+            } else {
+                _serve_client(epoll_fd, tree, c);
+            }
+        }
+    }
+
+    printf("shutting down with " BST_SIZE_FMT " keys\n", tree->length);
+
+    close(listen_fd);
+    unlink(path);
+    avl_clear_destroy(tree);
+    return 0;
+}
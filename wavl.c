@@ -0,0 +1,187 @@
+/*
+ * wavl.c
+ *
+ * An implementation of the Weak AVL (WAVL) Balanced Binary Search Tree
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "wavl.h"
+
+
+bst* wavl_create(void)
+{
+    return bst_create();
+}
+
+
+static void _wavl_insert_rebalance(bst* tree, bstnode* current)
+{
+    bstnode* parent = current->parent;
+
+    // the only possible violation after an insert is a rank difference of
+    // zero between current and its parent.
+    while (parent && WAVL_RANK(parent) == WAVL_RANK(current)) {
+        int side = (parent->left == current) ? LEFT : RIGHT;
+        bstnode* sibling = BRANCH(REVERSE_DIRECTION(side), parent);
+
+        if (WAVL_RANK(parent) - WAVL_RANK(sibling) == 1) {
+            // parent is 0,1: promote it and move up
+            parent->balance_factor++;
+            current = parent;
+            parent = current->parent;
+            continue;
+        }
+
+        // parent is 0,2, so rotate to fix it.
+        bstnode* inner = BRANCH(REVERSE_DIRECTION(side), current);
+
+        if (WAVL_RANK(current) - WAVL_RANK(inner) == 2) {
+            // single rotation
+            bst_rotate(tree, parent, REVERSE_DIRECTION(side));
+            parent->balance_factor--;
+        } else {
+            // double rotation
+            bst_rotate(tree, current, side);
+            bst_rotate(tree, parent, REVERSE_DIRECTION(side));
+            inner->balance_factor++;
+            current->balance_factor--;
+            parent->balance_factor--;
+        }
+
+        break;
+    }
+}
+
+
+int wavl_insert(bst* tree, bst_key value)
+{
+    bstnode* newnode = bst_create_node(tree, value);
+    newnode->balance_factor = 0;
+
+    if (tree->length == 0) {
+        bst_node_insert(tree, newnode, NULL);
+        return 1;
+    }
+
+    node* path_tracker = init_update_tracker();
+    bstnode* insert_location = bst_find_node_and_path(tree, value, &path_tracker, 1);
+
+    if (insert_location) {
+        revert_rank_updates(path_tracker, -1);
+        destroy_update_tracker(path_tracker);
+        free(newnode);
+        return 0;
+    }
+
+    bst_node_insert(tree, newnode, path_tracker);
+    destroy_update_tracker(path_tracker);
+
+    _wavl_insert_rebalance(tree, newnode);
+
+    return 1;
+}
+
+
+static void _wavl_delete_rebalance(bst* tree, bstnode* parent, int direction)
+{
+    if (!parent) {
+        return;
+    }
+
+    bstnode* current = BRANCH(direction, parent);
+
+    // Removing the only child of a unary node leaves a 2,2 leaf, which
+    // isn't allowed. Demote it, which may leave it as a 3-child.
+    if (!parent->left && !parent->right && WAVL_RANK(parent) == 1) {
+        parent->balance_factor = 0;
+        current = parent;
+        parent = current->parent;
+        if (parent)
+            direction = (parent->left == current) ? LEFT : RIGHT;
+    }
+
+    while (parent && WAVL_RANK(parent) - WAVL_RANK(current) == 3) {
+        bstnode* sibling = BRANCH(REVERSE_DIRECTION(direction), parent);
+
+        if (WAVL_RANK(parent) - WAVL_RANK(sibling) == 2) {
+            // parent is 3,2: demote it and move up
+            parent->balance_factor--;
+        } else {
+            bstnode* near = BRANCH(direction, sibling);
+            bstnode* far = BRANCH(REVERSE_DIRECTION(direction), sibling);
+            int sibling_rank = WAVL_RANK(sibling);
+
+            if (sibling_rank - WAVL_RANK(near) == 2 && sibling_rank - WAVL_RANK(far) == 2) {
+                // parent is 3,1 and sibling is 2,2: double demote and move up
+                parent->balance_factor--;
+                sibling->balance_factor--;
+            } else if (sibling_rank - WAVL_RANK(far) == 1) {
+                // single rotation
+                bst_rotate(tree, parent, direction);
+                sibling->balance_factor++;
+                parent->balance_factor--;
+
+                // a leaf must have rank zero
+                if (!parent->left && !parent->right)
+                    parent->balance_factor--;
+
+                return;
+            } else {
+                // double rotation
+                bst_rotate(tree, sibling, REVERSE_DIRECTION(direction));
+                bst_rotate(tree, parent, direction);
+                near->balance_factor += 2;
+                sibling->balance_factor--;
+                parent->balance_factor -= 2;
+
+                return;
+            }
+        }
+
+        current = parent;
+        parent = current->parent;
+        if (parent)
+            direction = (parent->left == current) ? LEFT : RIGHT;
+    }
+}
+
+
+int wavl_delete(bst* tree, bst_key value)
+{
+    bstnode* todelete = bst_search(tree, value);
+
+    if (!todelete) {
+        return 0;
+    }
+
+    int direction;
+    bstnode* parent = bst_node_unlink(tree, todelete, &direction);
+    bst_free_node(tree, todelete);
+
+    _wavl_delete_rebalance(tree, parent, direction);
+
+    return 1;
+}
+
+
+bstnode* wavl_search(bst* tree, bst_key value)
+{
+    return bst_search(tree, value);
+}
+
+
+bstnode* wavl_index(bst* tree, bst_size index)
+{
+    return bst_index(tree, index);
+}
+
+
+bst_size wavl_get_index(bst* tree, bst_key value)
+{
+    return bst_get_index(tree, value);
+}
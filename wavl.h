@@ -0,0 +1,30 @@
+/*
+ * wavl.h
+ *
+ * An implementation of the Weak AVL (WAVL) Balanced Binary Search Tree, as
+ * described by Haeupler, Sen and Tarjan in "Rank-Balanced Trees". Insertions
+ * behave exactly like AVL, but deletions need at most two rotations. The
+ * WAVL rank of each node (not to be confused with the rank used for indexing)
+ * is stored in its balance_factor field.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include "nodes.h"
+#include <assert.h>
+#include "bst.h"
+#include "tracker.h"
+
+// missing children have a WAVL rank of -1, leaves have a rank of 0
+#define WAVL_RANK(node) ((node) ? (node)->balance_factor : -1)
+
+bst* wavl_create(void);
+
+int wavl_insert(bst* tree, bst_key value);
+int wavl_delete(bst* tree, bst_key value);
+bstnode* wavl_search(bst* tree, bst_key value);
+bstnode* wavl_index(bst* tree, bst_size index);
+bst_size wavl_get_index(bst* tree, bst_key value);
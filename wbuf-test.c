@@ -0,0 +1,182 @@
+/*
+ * wbuf-test.c
+ * A simple test suite for the write buffer, checking that searches and rank
+ * queries over the buffer and tree together stay exact, for a few different
+ * buffer sizes.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+
+#include "wbuf.h"
+#include "bst-util.h"
+
+
+void check_buffer(write_buffer* buffer, char* present, int range)
+{
+    int index = 0;
+    for (int x=0; x<range; x++) {
+        int value;
+        if (present[x]) {
+            index++;
+            assert(wbuf_search(buffer, x));
+            assert(wbuf_get_index(buffer, x) == index);
+            assert(wbuf_index(buffer, index, &value) && value == x);
+        } else {
+            assert(!wbuf_search(buffer, x));
+            assert(wbuf_get_index(buffer, x) == -1);
+        }
+    }
+
+    assert(wbuf_length(buffer) == index);
+
+    int value;
+    assert(!wbuf_index(buffer, 0, &value));
+    assert(!wbuf_index(buffer, index + 1, &value));
+}
+
+
+void check_tree(bst* tree)
+{
+    check_bst_ordering(tree);
+    check_parent_links(tree->head);
+    check_extremes(tree);
+    assert(check_subtree_ranks(tree->head) == tree->length);
+    assert(check_balance_factors(tree->head) == tree->height);
+    check_strict_balance(tree->head, 0);
+}
+
+
+int standard_tests()
+{
+    write_buffer* buffer = wbuf_create(8);
+    int value;
+
+    assert(wbuf_length(buffer) == 0);
+    assert(!wbuf_search(buffer, 5));
+    assert(!wbuf_index(buffer, 1, &value));
+
+    wbuf_insert(buffer, 5);
+    wbuf_insert(buffer, 3);
+    wbuf_insert(buffer, 5);
+    assert(wbuf_length(buffer) == 2);
+    assert(buffer->tree->length == 0);
+    assert(wbuf_get_index(buffer, 5) == 2);
+    assert(wbuf_index(buffer, 1, &value) && value == 3);
+
+    wbuf_delete(buffer, 3);
+    wbuf_insert(buffer, 3);
+    wbuf_delete(buffer, 3);
+    assert(!wbuf_search(buffer, 3) && wbuf_length(buffer) == 1);
+
+    wbuf_flush(buffer);
+    assert(buffer->tree->length == 1 && avl_search(buffer->tree, 5));
+
+    wbuf_delete(buffer, 5);
+    assert(avl_search(buffer->tree, 5) && !wbuf_search(buffer, 5));
+    assert(wbuf_length(buffer) == 0);
+    wbuf_flush(buffer);
+    assert(!buffer->tree->head);
+
+    printf("standard tests passed\n");
+    wbuf_clear_destroy(buffer);
+    return 0;
+}
+
+
+int delete_run_tests(int n)
+{
+    // a long run of pending deletes in the middle of the tree, which every
+    // index past it has to count its way over
+    write_buffer* buffer = wbuf_create(n);
+    char* present = calloc(n, 1);
+
+    printf("Indexing past a run of pending deletes...\n");
+    for (int x=1; x<n; x++) {
+        wbuf_insert(buffer, x);
+        present[x] = 1;
+    }
+    wbuf_flush(buffer);
+
+    for (int x=n / 4; x<3 * n / 4; x++) {
+        wbuf_delete(buffer, x);
+        present[x] = 0;
+    }
+    wbuf_insert(buffer, 0);
+    present[0] = 1;
+    assert(buffer->tree->length == n - 1 && buffer->log_count == n / 2 + 1);
+
+    int value;
+    assert(wbuf_index(buffer, 1, &value) && value == 0);
+    assert(wbuf_index(buffer, n / 4, &value) && value == n / 4 - 1);
+    assert(wbuf_index(buffer, n / 4 + 1, &value) && value == 3 * n / 4);
+    assert(wbuf_index(buffer, n / 2, &value) && value == n - 1);
+    assert(!wbuf_index(buffer, n / 2 + 1, &value));
+
+    check_buffer(buffer, present, n);
+    assert(buffer->delete_count == n / 2 && buffer->insert_count == 1);
+
+    printf("\tpassed\n");
+    free(present);
+    wbuf_clear_destroy(buffer);
+    return 0;
+}
+
+
+int random_tests(int capacity, int range, int ops)
+{
+    printf("Random writes and queries with a buffer of %d...\n", capacity);
+    write_buffer* buffer = wbuf_create(capacity);
+    char* present = calloc(range, 1);
+
+    for (int i=0; i<ops; i++) {
+        int x = rand() % range;
+        if (rand() % 3) {
+            wbuf_insert(buffer, x);
+            present[x] = 1;
+        } else {
+            wbuf_delete(buffer, x);
+            present[x] = 0;
+        }
+
+        if (i % (ops / 10) == 0) {
+            check_buffer(buffer, present, range);
+            check_tree(buffer->tree);
+        }
+    }
+
+    wbuf_flush(buffer);
+    check_tree(buffer->tree);
+    check_buffer(buffer, present, range);
+    assert(buffer->tree->length == wbuf_length(buffer));
+
+    wbuf_set_capacity(buffer, capacity * 4);
+    check_buffer(buffer, present, range);
+
+    printf("\tpassed\n");
+    free(present);
+    wbuf_clear_destroy(buffer);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    srand(time(NULL));
+    standard_tests();
+    delete_run_tests(4096);
+
+    random_tests(1, 2000, 20000);
+    random_tests(16, 2000, 20000);
+    random_tests(256, 2000, 20000);
+    random_tests(4096, 20000, 100000);
+
+    return 0;
+}
@@ -0,0 +1,379 @@
+/*
+ * wbuf.c
+ *
+ * A write buffer in front of an AVL tree.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include "wbuf.h"
+
+
+static void* _wbuf_malloc(size_t size)
+{
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr) {
+        fprintf(stderr, "MEMORY ERROR in wbuf.c. Mallocation failed.\n");
+        exit(-1);
+    }
+
+    return ptr;
+}
+
+
+write_buffer* wbuf_create(int capacity)
+{
+    write_buffer* buffer = _wbuf_malloc(sizeof(write_buffer));
+    memset(buffer, 0, sizeof(write_buffer));
+
+    buffer->tree = avl_create();
+    wbuf_set_capacity(buffer, capacity);
+
+    return buffer;
+}
+
+
+void wbuf_set_capacity(write_buffer* buffer, int capacity)
+{
+    if (capacity <= 0) capacity = WBUF_DEFAULT_CAPACITY;
+
+    // the resolved writes never outnumber the ones in the log, so each of
+    // the arrays needs at most capacity entries.
+    wbuf_flush(buffer);
+    free(buffer->log);
+    free(buffer->inserts);
+    free(buffer->deletes);
+    free(buffer->spare_inserts);
+    free(buffer->spare_deletes);
+
+    buffer->log = _wbuf_malloc(sizeof(wbuf_op) * capacity);
+    buffer->inserts = _wbuf_malloc(sizeof(int) * capacity);
+    buffer->deletes = _wbuf_malloc(sizeof(int) * capacity);
+    buffer->spare_inserts = _wbuf_malloc(sizeof(int) * capacity);
+    buffer->spare_deletes = _wbuf_malloc(sizeof(int) * capacity);
+    buffer->capacity = capacity;
+}
+
+
+static int _count_below(const int* keys, int n, int value)
+{
+    // the number of keys less than value
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (keys[mid] < value)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+
+static int _contains(const int* keys, int n, int value)
+{
+    int i = _count_below(keys, n, value);
+    return i < n && keys[i] == value;
+}
+
+
+static int _compare_ops(const void* a, const void* b)
+{
+    const wbuf_op* x = a;
+    const wbuf_op* y = b;
+
+    if (x->key != y->key)
+        return (x->key > y->key) - (x->key < y->key);
+
+    return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+
+static void _wbuf_settle(write_buffer* buffer)
+{
+    // Resolves the log into the sorted insert and delete arrays. Only the
+    // last write to each key counts, and only if it changes whether the key
+    // is present, which takes a tree search per distinct key in the log.
+    // The merge is written into the spare arrays, which then trade places
+    // with the current ones, so that settling allocates nothing.
+    if (!buffer->log_count) return;
+
+    qsort(buffer->log, buffer->log_count, sizeof(wbuf_op), _compare_ops);
+
+    int* inserts = buffer->spare_inserts;
+    int* deletes = buffer->spare_deletes;
+    int insert_count = 0, delete_count = 0;
+
+    int i = 0, j = 0, l = 0;
+    while (i < buffer->insert_count || j < buffer->delete_count || l < buffer->log_count) {
+        int key = (l < buffer->log_count) ? buffer->log[l].key : INT_MAX;
+        if (i < buffer->insert_count && buffer->inserts[i] < key)
+            key = buffer->inserts[i];
+        if (j < buffer->delete_count && buffer->deletes[j] < key)
+            key = buffer->deletes[j];
+
+        int pending_insert = (i < buffer->insert_count && buffer->inserts[i] == key);
+        int pending_delete = (j < buffer->delete_count && buffer->deletes[j] == key);
+        i += pending_insert;
+        j += pending_delete;
+
+        if (l == buffer->log_count || buffer->log[l].key != key) {
+            // untouched by the log, so it stays as it was
+            if (pending_insert) inserts[insert_count++] = key;
+            if (pending_delete) deletes[delete_count++] = key;
+            continue;
+        }
+
+        while (l + 1 < buffer->log_count && buffer->log[l + 1].key == key)
+            l++;
+        int wanted = (buffer->log[l++].op == WBUF_INSERT);
+
+        int in_tree = (pending_delete) ? 1 : (pending_insert) ? 0 :
+            avl_search(buffer->tree, key) != NULL;
+
+        if (wanted && !in_tree)
+            inserts[insert_count++] = key;
+        else if (!wanted && in_tree)
+            deletes[delete_count++] = key;
+    }
+
+    buffer->spare_inserts = buffer->inserts;
+    buffer->spare_deletes = buffer->deletes;
+    buffer->inserts = inserts;
+    buffer->deletes = deletes;
+    buffer->insert_count = insert_count;
+    buffer->delete_count = delete_count;
+    buffer->log_count = 0;
+}
+
+
+static int _built_height(int n)
+{
+    int height = 0;
+    for (; n; n >>= 1)
+        height++;
+
+    return height;
+}
+
+
+static bstnode* _wbuf_link(bst* tree, bstnode** nodes, int n, bstnode* parent)
+{
+    // Links the sorted nodes into a perfectly balanced tree, as in
+    // avl_build_parallel, with any extra node on the left.
+    if (n == 0) return NULL;
+
+    int left_n = n / 2;
+    int right_n = n - left_n - 1;
+
+    bstnode* head = nodes[left_n];
+    head->parent = parent;
+    head->rank = left_n + 1;
+    head->balance_factor = _built_height(right_n) - _built_height(left_n);
+    head->left = _wbuf_link(tree, nodes, left_n, head);
+    head->right = _wbuf_link(tree, nodes + left_n + 1, right_n, head);
+
+    if (tree->augment)
+        bst_update_aggregates(tree, head);
+
+    return head;
+}
+
+
+static void _wbuf_rebuild(write_buffer* buffer)
+{
+    // merges the resolved writes with the nodes of the tree in order, reusing
+    // the nodes of the keys that stay, and relinks the result. The old nodes
+    // are all gathered first, as stepping through the tree needs the ones
+    // already passed.
+    bst* tree = buffer->tree;
+    int n = tree->length + buffer->insert_count - buffer->delete_count;
+    bstnode** existing = _wbuf_malloc(sizeof(bstnode*) * tree->length);
+    bstnode** nodes = _wbuf_malloc(sizeof(bstnode*) * n);
+
+    int old_n = 0;
+    for (bstnode* current = bst_node_min(tree->head); current; current = bst_node_next(current))
+        existing[old_n++] = current;
+
+    int count = 0, i = 0, j = 0, k = 0;
+    while (k < old_n || i < buffer->insert_count) {
+        if (k == old_n || (i < buffer->insert_count && buffer->inserts[i] < existing[k]->value)) {
+            nodes[count] = bst_create_node(tree, buffer->inserts[i++]);
+            if (tree->hash)
+                bst_hash_put(tree->hash, nodes[count]);
+            count++;
+        } else if (j < buffer->delete_count && buffer->deletes[j] == existing[k]->value) {
+            if (tree->hash)
+                bst_hash_remove(tree->hash, existing[k]->value);
+            if (tree->cache)
+                bst_cache_remove(tree->cache, existing[k]->value);
+            bst_free_node(tree, existing[k++]);
+            j++;
+        } else {
+            nodes[count++] = existing[k++];
+        }
+    }
+
+    tree->head = _wbuf_link(tree, nodes, n, NULL);
+    tree->length = n;
+    tree->height = _built_height(n);
+    if (tree->cache)
+        bst_cache_ranks_changed(tree->cache);
+    tree->leftmost = (n) ? nodes[0] : NULL;
+    tree->rightmost = (n) ? nodes[n - 1] : NULL;
+
+    free(existing);
+    free(nodes);
+}
+
+
+void wbuf_flush(write_buffer* buffer)
+{
+    _wbuf_settle(buffer);
+
+    int writes = buffer->insert_count + buffer->delete_count;
+    if (!writes) return;
+
+    // Relinking costs O(n) no matter how few writes there are, while
+    // applying them one at a time costs O(lg n) each.
+    if ((long long) writes * (buffer->tree->height + 1) >= buffer->tree->length) {
+        _wbuf_rebuild(buffer);
+    } else {
+        for (int j=0; j<buffer->delete_count; j++)
+            avl_delete(buffer->tree, buffer->deletes[j]);
+
+        for (int i=0; i<buffer->insert_count; i++)
+            avl_insert(buffer->tree, buffer->inserts[i]);
+    }
+
+    buffer->insert_count = 0;
+    buffer->delete_count = 0;
+}
+
+
+static void _wbuf_append(write_buffer* buffer, int value, int op)
+{
+    wbuf_op* entry = &buffer->log[buffer->log_count];
+    entry->key = value;
+    entry->op = op;
+    entry->seq = buffer->log_count++;
+
+    if (buffer->log_count + buffer->insert_count + buffer->delete_count >= buffer->capacity)
+        wbuf_flush(buffer);
+}
+
+
+void wbuf_insert(write_buffer* buffer, int value)
+{
+    _wbuf_append(buffer, value, WBUF_INSERT);
+}
+
+
+void wbuf_delete(write_buffer* buffer, int value)
+{
+    _wbuf_append(buffer, value, WBUF_DELETE);
+}
+
+
+int wbuf_search(write_buffer* buffer, int value)
+{
+    _wbuf_settle(buffer);
+
+    if (_contains(buffer->inserts, buffer->insert_count, value))
+        return 1;
+    if (_contains(buffer->deletes, buffer->delete_count, value))
+        return 0;
+
+    return avl_search(buffer->tree, value) != NULL;
+}
+
+
+static int _wbuf_count_below(write_buffer* buffer, int value)
+{
+    // the number of keys, buffered or not, less than value
+    bst_size rank;
+    bst_lower_bound(buffer->tree, value, &rank);
+
+    return rank - 1
+        + _count_below(buffer->inserts, buffer->insert_count, value)
+        - _count_below(buffer->deletes, buffer->delete_count, value);
+}
+
+
+int wbuf_get_index(write_buffer* buffer, int value)
+{
+    if (!wbuf_search(buffer, value))
+        return -1;
+
+    return _wbuf_count_below(buffer, value) + 1;
+}
+
+
+int wbuf_index(write_buffer* buffer, int index, int* value)
+{
+    if (index < 1 || index > wbuf_length(buffer))
+        return 0;
+
+    // find the last pending insert at or before index. The indexes of the
+    // pending inserts increase with their position, so this is a binary
+    // search, at the cost of a tree descent per probe.
+    int lo = 0, hi = buffer->insert_count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (_wbuf_count_below(buffer, buffer->inserts[mid]) + 1 <= index)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo && _wbuf_count_below(buffer, buffer->inserts[lo - 1]) + 1 == index) {
+        *value = buffer->inserts[lo - 1];
+        return 1;
+    }
+
+    // Otherwise it's the target'th key in the tree that isn't about to be
+    // deleted. Its index in the tree is target plus the number of deletes
+    // before it. The pending delete at position j has rank - 1 - j keys
+    // that stay below it, which never decreases with j, so the deletes
+    // before the key are those with fewer than target below them, found by
+    // another binary search with a tree descent per probe.
+    int target = index - lo;
+    lo = 0, hi = buffer->delete_count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (bst_get_index(buffer->tree, buffer->deletes[mid]) - 1 - mid < target)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    *value = avl_index(buffer->tree, target + lo)->value;
+    return 1;
+}
+
+
+int wbuf_length(write_buffer* buffer)
+{
+    _wbuf_settle(buffer);
+
+    return buffer->tree->length + buffer->insert_count - buffer->delete_count;
+}
+
+
+void wbuf_clear_destroy(write_buffer* buffer)
+{
+    avl_clear_destroy(buffer->tree);
+    free(buffer->log);
+    free(buffer->inserts);
+    free(buffer->deletes);
+    free(buffer->spare_inserts);
+    free(buffer->spare_deletes);
+    free(buffer);
+}
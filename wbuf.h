@@ -0,0 +1,75 @@
+/*
+ * wbuf.h
+ *
+ * A write buffer in front of an AVL tree, for absorbing bursts of inserts and
+ * deletes. Writes are only appended to a log, which costs O(1), and are merged
+ * into the tree in sorted batches once the buffer fills up. A batch that is
+ * large next to the tree is merged by relinking the whole tree into a perfectly
+ * balanced one, and a smaller one by inserting and deleting in key order, so
+ * that consecutive operations share most of their path.
+ *
+ * Reads stay exact. Before answering, the log is sorted and resolved against
+ * the tree into the keys waiting to be inserted (which aren't in the tree) and
+ * those waiting to be deleted (which are), so that a rank in the combined set
+ * is the rank in the tree adjusted by a binary search of each. The capacity
+ * trades the cost of reads (and of resolving the log) against write
+ * throughput.
+ *
+ * As the buffered keys don't have nodes yet, lookups return keys rather than
+ * nodes. Once flushed, the tree can be used directly.
+ *
+ * Douglas Rumbaugh
+ * 10/19/2026
+ *
+ */
+#pragma once
+
+#include "avl.h"
+
+#ifndef WBUF_DEFAULT_CAPACITY
+#define WBUF_DEFAULT_CAPACITY 4096
+#endif
+
+#define WBUF_INSERT 1
+#define WBUF_DELETE 0
+
+typedef struct WBufOp {
+    int key;
+    int op;
+    int seq;
+} wbuf_op;
+
+typedef struct WriteBuffer {
+    bst* tree;
+
+    // writes not yet resolved, in arrival order
+    wbuf_op* log;
+    int log_count;
+
+    // resolved writes, sorted: keys to be inserted, none of which are in the
+    // tree, and keys to be deleted, all of which are
+    int* inserts;
+    int insert_count;
+    int* deletes;
+    int delete_count;
+
+    // the arrays the next settle merges into, swapped with the two above
+    int* spare_inserts;
+    int* spare_deletes;
+
+    int capacity;
+} write_buffer;
+
+write_buffer* wbuf_create(int capacity);
+void wbuf_set_capacity(write_buffer* buffer, int capacity);
+
+void wbuf_insert(write_buffer* buffer, int value);
+void wbuf_delete(write_buffer* buffer, int value);
+void wbuf_flush(write_buffer* buffer);
+
+int wbuf_search(write_buffer* buffer, int value);
+int wbuf_index(write_buffer* buffer, int index, int* value);
+int wbuf_get_index(write_buffer* buffer, int value);
+int wbuf_length(write_buffer* buffer);
+
+void wbuf_clear_destroy(write_buffer* buffer);